@@ -349,6 +349,16 @@ size_t Atom::getIncomingSetSize() const
     return cnt;
 }
 
+size_t Atom::getIncomingSetSizeByType(Type type) const
+{
+    if (NULL == _incoming_set) return 0;
+    std::lock_guard<std::mutex> lck (_mtx);
+
+    const auto bucket = _incoming_set->_iset.find(type);
+    if (bucket == _incoming_set->_iset.cend()) return 0;
+    return bucket->second.size();
+}
+
 // We return a copy here, and not a reference, because the set itself
 // is not thread-safe during reading while simultaneous insertion and
 // deletion.  Besides, the incoming set is weak; we have to make it
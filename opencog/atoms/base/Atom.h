@@ -285,6 +285,10 @@ public:
     //! Get the size of the incoming set.
     size_t getIncomingSetSize() const;
 
+    //! Get the number of links of the given type in the incoming set.
+    //! This is cheap; the incoming set is already bucketed by type.
+    size_t getIncomingSetSizeByType(Type) const;
+
     //! Return the incoming set of this atom.
     //! If the AtomSpace pointer is non-null, then only those atoms
     //! that belonged to that atomspace at the time this call was made
@@ -54,7 +54,10 @@ public:
 
 	virtual ~FloatValue() {}
 
-	const std::vector<double>& value() const { return _value; }
+	/// Return the stored values.  This is virtual, so that compact
+	/// subclasses that do not keep the vector (such as the
+	/// CompactTruthValue) can synthesize it on demand.
+	virtual const std::vector<double>& value() const { return _value; }
 
 	/** Returns a string representation of the value.  */
 	virtual std::string toString(const std::string& indent = "") const;
@@ -21,6 +21,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cmath>
+#include <cstdint>
+
 #include <opencog/atoms/base/Atom.h>
 #include <opencog/atoms/base/Link.h>
 #include <opencog/atoms/base/ClassServer.h>
@@ -537,6 +540,25 @@ bool Variables::is_upper_bound(const Handle& glob, size_t n) const
 	return false;
 }
 
+/**
+ * Interval bounds.
+ *
+ * Returns the least and the most number of atoms that the glob can be
+ * grounded by; the most is SIZE_MAX if the interval has no upper end.
+ */
+std::pair<size_t, size_t> Variables::get_interval(const Handle& glob) const
+{
+	GlobIntervalMap::const_iterator iit = _glob_intervalmap.find(glob);
+
+	// No interval restrictions means one to many.
+	if (_glob_intervalmap.end() == iit) return {1, SIZE_MAX};
+
+	const std::pair<double, double>& intervals = iit->second;
+	size_t lo = 0 < intervals.first ? std::ceil(intervals.first) : 0;
+	size_t hi = intervals.second < 0 ? SIZE_MAX : std::floor(intervals.second);
+	return {lo, hi};
+}
+
 /* ================================================================= */
 /**
  * Substitute the given values for the variables occuring in a tree.
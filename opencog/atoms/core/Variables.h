@@ -191,6 +191,11 @@ struct Variables : public FreeVariables
 	// Return false otherwise.
 	bool is_upper_bound(const Handle& glob, size_t n) const;
 
+	// Return the least and the most number of atoms that the glob
+	// may match, as allowed by the two checks above. The most is
+	// SIZE_MAX if there is no upper bound.
+	std::pair<size_t, size_t> get_interval(const Handle& glob) const;
+
 	// Given the tree `tree` containing variables in it, create and
 	// return a new tree with the indicated values `vals` substituted
 	// for the variables. The vals must pass the typecheck, else an
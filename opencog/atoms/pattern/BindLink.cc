@@ -40,11 +40,20 @@ void BindLink::init(void)
 			"Expecting a BindLink, got %s", tname.c_str());
 	}
 
+	// The rewrite term is always the last one; it is not part of
+	// the cached plan.
+	if (load_plan())
+	{
+		_implicand = _outgoing.back();
+		return;
+	}
+
 	extract_variables(_outgoing);
 	unbundle_clauses(_body);
 	common_init();
 	setup_components();
 	_pat.redex_name = "anonymous BindLink";
+	store_plan();
 }
 
 BindLink::BindLink(const Handle& vardecl,
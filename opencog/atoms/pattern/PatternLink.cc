@@ -23,6 +23,10 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
 #include <boost/range/algorithm/find_if.hpp>
 
 #include <opencog/util/Logger.h>
@@ -130,8 +134,413 @@ void PatternLink::setup_components(void)
 	}
 }
 
+/* ================================================================= */
+// The compiled-plan cache. A plan is a copy of everything that the
+// constructors compute; see the notes in PatternLink.h.
+
+struct PatternLink::Plan
+{
+	Type type;
+	HandleSeq outgoing;
+
+	Handle vardecl;
+	Handle body;
+	Variables varlist;
+	Pattern pat;
+
+	HandleSeq fixed;
+	size_t num_virts;
+	HandleSeq virtuals;
+	size_t num_comps;
+	HandleSeqSeq components;
+	std::vector<HandleSet> component_vars;
+	HandleSeq component_patterns;
+};
+
+typedef std::shared_ptr<const PatternLink::Plan> PlanPtr;
+
+/// The plans are owned by the PatternLinks made from them; the cache
+/// only points at them, so that it does not keep any atoms alive.
+/// The entries are kept in order of use, most recent first, and the
+/// least recently used one is dropped to make room.
+struct PlanCache
+{
+	struct Entry
+	{
+		ContentHash key;
+		std::weak_ptr<const PatternLink::Plan> plan;
+	};
+	typedef std::list<Entry> Entries;
+
+	std::mutex mtx;
+	Entries lru;
+	std::unordered_multimap<ContentHash, Entries::iterator> plans;
+	size_t max_size;
+	size_t hits;
+	size_t alpha_hits;
+	size_t misses;
+
+	PlanCache() : max_size(1024), hits(0), alpha_hits(0), misses(0)
+	{
+		// A new atom type might be a new connective, or a new kind of
+		// virtual or evaluatable link, changing how patterns unpack.
+		classserver().addTypeSignal().connect(
+			[this](Type) { std::lock_guard<std::mutex> lck(mtx); clear(); });
+	}
+
+	// The caller holds the lock in all of the below.
+	void touch(Entries::iterator it)
+	{
+		lru.splice(lru.begin(), lru, it);
+	}
+
+	void drop(Entries::iterator it)
+	{
+		auto range = plans.equal_range(it->key);
+		for (auto pit = range.first; pit != range.second; pit++)
+		{
+			if (pit->second != it) continue;
+			plans.erase(pit);
+			break;
+		}
+		lru.erase(it);
+	}
+
+	/// Drop the plans whose patterns are all gone.
+	void drop_expired(void)
+	{
+		for (auto it = lru.begin(); it != lru.end(); )
+		{
+			auto next = std::next(it);
+			if (it->plan.expired()) drop(it);
+			it = next;
+		}
+	}
+
+	void trim(size_t sz)
+	{
+		while (sz < lru.size()) drop(std::prev(lru.end()));
+	}
+
+	void clear(void)
+	{
+		plans.clear();
+		lru.clear();
+	}
+};
+
+static PlanCache& plan_cache(void)
+{
+	static PlanCache cache;
+	return cache;
+}
+
+/// A hash of the outgoing set that does not depend on the names of
+/// the variables: each variable counts by its order of appearance.
+static ContentHash shape_hash(const Handle& h,
+                              std::unordered_map<Handle, size_t>& order)
+{
+	Type t = h->getType();
+	if (VARIABLE_NODE == t or GLOB_NODE == t)
+	{
+		size_t n = order.size();
+		auto it = order.emplace(h, n).first;
+		return ((ContentHash) t << 32) + 1 + it->second;
+	}
+	if (h->isNode()) return h->get_hash();
+
+	ContentHash key = t;
+	for (const Handle& ho : h->getOutgoingSet())
+		key = 31 * key + shape_hash(ho, order);
+	return key;
+}
+
+static ContentHash plan_key(Type t, const HandleSeq& oset)
+{
+	std::unordered_map<Handle, size_t> order;
+	ContentHash key = t;
+	for (const Handle& h : oset)
+		key = 31 * key + shape_hash(h, order);
+	return key;
+}
+
+/// Pair up the atoms of `a` with those in the same place in `b`.
+/// Return false unless `b` is `a` with its variables renamed, one for
+/// one; the pairing is then in `rename`. Unordered links count as
+/// different if renaming reorders them.
+static bool pair_up(const Handle& a, const Handle& b,
+                    HandleMap& rename, HandleMap& inverse)
+{
+	auto it = rename.find(a);
+	if (rename.end() != it) return it->second == b;
+	if (inverse.end() != inverse.find(b)) return false;
+
+	Type t = a->getType();
+	if (b->getType() != t) return false;
+	if (a->isNode())
+	{
+		if (VARIABLE_NODE != t and GLOB_NODE != t and *a != *b)
+			return false;
+	}
+	else
+	{
+		const HandleSeq& oa = a->getOutgoingSet();
+		const HandleSeq& ob = b->getOutgoingSet();
+		if (oa.size() != ob.size()) return false;
+		for (size_t i = 0; i < oa.size(); i++)
+			if (not pair_up(oa[i], ob[i], rename, inverse)) return false;
+	}
+
+	rename.emplace(a, b);
+	inverse.emplace(b, a);
+	return true;
+}
+
+/// Renames the atoms of a plan, as paired up by pair_up(). Atoms that
+/// the analysis made, rather than found in the pattern, are rebuilt
+/// around the renamed atoms.
+struct PlanRenamer
+{
+	HandleMap rename;
+
+	Handle operator()(const Handle& h)
+	{
+		if (nullptr == h) return h;
+		auto it = rename.find(h);
+		if (rename.end() != it) return it->second;
+		if (h->isNode()) return h;
+
+		HandleSeq oset;
+		bool changed = false;
+		for (const Handle& ho : h->getOutgoingSet())
+		{
+			oset.emplace_back(operator()(ho));
+			changed = changed or oset.back() != ho;
+		}
+		Handle hr(h);
+		if (changed)
+			hr = classserver().factory(Handle(createLink(oset, h->getType())));
+		rename.emplace(h, hr);
+		return hr;
+	}
+
+	HandleSeq operator()(const HandleSeq& hs)
+	{
+		HandleSeq out;
+		for (const Handle& h : hs) out.emplace_back(operator()(h));
+		return out;
+	}
+
+	HandleSet operator()(const HandleSet& hs)
+	{
+		HandleSet out;
+		for (const Handle& h : hs) out.insert(operator()(h));
+		return out;
+	}
+
+	std::unordered_multimap<Handle, Handle>
+	operator()(const std::unordered_multimap<Handle, Handle>& mm)
+	{
+		std::unordered_multimap<Handle, Handle> out;
+		for (const auto& pr : mm)
+			out.emplace(operator()(pr.first), operator()(pr.second));
+		return out;
+	}
+
+	template<typename Map>
+	Map keys(const Map& m)
+	{
+		Map out;
+		for (const auto& pr : m)
+			out.emplace(operator()(pr.first), pr.second);
+		return out;
+	}
+};
+
+/// Copy the analysis of an identical, or alpha-equivalent, pattern
+/// out of the cache. Return false if there is none; the pattern must
+/// then be analyzed.
+bool PatternLink::load_plan(void)
+{
+	PlanCache& cache = plan_cache();
+	ContentHash key = plan_key(getType(), _outgoing);
+
+	std::unique_lock<std::mutex> lck(cache.mtx);
+	PlanPtr plan;
+	PlanRenamer rn;
+	auto range = cache.plans.equal_range(key);
+	for (auto it = range.first; it != range.second; it++)
+	{
+		PlanPtr p(it->second->plan.lock());
+		if (nullptr == p or p->type != getType()) continue;
+
+		if (p->outgoing == _outgoing)
+		{
+			plan = p;
+			rn.rename.clear();
+			cache.touch(it->second);
+			break;
+		}
+
+		// Keep looking for an identical one.
+		if (nullptr != plan) continue;
+		HandleMap inverse;
+		rn.rename.clear();
+		bool paired = p->outgoing.size() == _outgoing.size();
+		for (size_t i = 0; paired and i < _outgoing.size(); i++)
+			paired = pair_up(p->outgoing[i], _outgoing[i], rn.rename, inverse);
+		if (paired)
+		{
+			plan = p;
+			cache.touch(it->second);
+		}
+	}
+	if (nullptr == plan)
+	{
+		cache.misses++;
+		return false;
+	}
+	cache.hits++;
+	if (not rn.rename.empty()) cache.alpha_hits++;
+	lck.unlock();
+
+	if (rn.rename.empty())
+	{
+		_vardecl = plan->vardecl;
+		_body = plan->body;
+		_varlist = plan->varlist;
+		_pat = plan->pat;
+		_fixed = plan->fixed;
+		_num_virts = plan->num_virts;
+		_virtual = plan->virtuals;
+		_num_comps = plan->num_comps;
+		_components = plan->components;
+		_component_vars = plan->component_vars;
+		_component_patterns = plan->component_patterns;
+		_plan = plan;
+		return true;
+	}
+
+	// Alpha-equivalent: the same analysis, on this pattern's atoms.
+	_vardecl = rn(plan->vardecl);
+	_body = rn(plan->body);
+
+	const Variables& vars = plan->varlist;
+	_varlist.varseq = rn(vars.varseq);
+	_varlist.varset = rn(vars.varset);
+	_varlist.index = rn.keys(vars.index);
+	_varlist._simple_typemap = rn.keys(vars._simple_typemap);
+	_varlist._glob_intervalmap = rn.keys(vars._glob_intervalmap);
+	for (const auto& pr : vars._deep_typemap)
+		_varlist._deep_typemap.emplace(rn(pr.first), rn(pr.second));
+	for (const auto& pr : vars._fuzzy_typemap)
+		_varlist._fuzzy_typemap.emplace(rn(pr.first), rn(pr.second));
+
+	const Pattern& pat = plan->pat;
+	_pat.redex_name = pat.redex_name;
+	_pat.body = rn(pat.body);
+	_pat.clauses = rn(pat.clauses);
+	_pat.constants = rn(pat.constants);
+	_pat.cnf_clauses = rn(pat.cnf_clauses);
+	_pat.mandatory = rn(pat.mandatory);
+	_pat.optionals = rn(pat.optionals);
+	_pat.black = rn(pat.black);
+	_pat.evaluatable_terms = rn(pat.evaluatable_terms);
+	_pat.evaluatable_holders = rn(pat.evaluatable_holders);
+	_pat.executable_terms = rn(pat.executable_terms);
+	_pat.executable_holders = rn(pat.executable_holders);
+	_pat.defined_terms = rn(pat.defined_terms);
+	_pat.globby_terms = rn(pat.globby_terms);
+	_pat.fuzzy_terms = rn(pat.fuzzy_terms);
+	_pat.in_evaluatable = rn(pat.in_evaluatable);
+	_pat.in_executable = rn(pat.in_executable);
+	_pat.connectivity_map = rn(pat.connectivity_map);
+
+	_fixed = rn(plan->fixed);
+	_num_virts = plan->num_virts;
+	_virtual = rn(plan->virtuals);
+	_num_comps = plan->num_comps;
+	for (const HandleSeq& comp : plan->components)
+		_components.emplace_back(rn(comp));
+	for (const HandleSet& cvars : plan->component_vars)
+		_component_vars.emplace_back(rn(cvars));
+
+	// The term trees and the component patterns hold the atoms too
+	// deeply to rename; they are cheap to make again.
+	if (not pat.connected_terms_map.empty())
+		make_term_trees();
+	setup_components();
+
+	// Cache this pattern as well, in case the other one goes away.
+	store_plan();
+	return true;
+}
+
+void PatternLink::store_plan(void)
+{
+	PlanCache& cache = plan_cache();
+	if (0 == cache.max_size) return;
+
+	std::shared_ptr<Plan> plan(std::make_shared<Plan>());
+	plan->type = getType();
+	plan->outgoing = _outgoing;
+	plan->vardecl = _vardecl;
+	plan->body = _body;
+	plan->varlist = _varlist;
+	plan->pat = _pat;
+	plan->fixed = _fixed;
+	plan->num_virts = _num_virts;
+	plan->virtuals = _virtual;
+	plan->num_comps = _num_comps;
+	plan->components = _components;
+	plan->component_vars = _component_vars;
+	plan->component_patterns = _component_patterns;
+	_plan = plan;
+
+	ContentHash key = plan_key(getType(), _outgoing);
+	std::lock_guard<std::mutex> lck(cache.mtx);
+
+	// Make room by dropping the plans of patterns that are gone, and
+	// then the least recently used ones. The cache is meant to hold a
+	// working set of rules, not every pattern ever seen.
+	cache.drop_expired();
+	cache.trim(cache.max_size - 1);
+
+	cache.lru.push_front({key, plan});
+	cache.plans.emplace(key, cache.lru.begin());
+}
+
+PatternLink::PlanCacheStats PatternLink::plan_cache_stats(void)
+{
+	PlanCache& cache = plan_cache();
+	std::lock_guard<std::mutex> lck(cache.mtx);
+	cache.drop_expired();
+	return PlanCacheStats{cache.hits, cache.alpha_hits, cache.misses,
+	                      cache.lru.size()};
+}
+
+void PatternLink::clear_plan_cache(void)
+{
+	PlanCache& cache = plan_cache();
+	std::lock_guard<std::mutex> lck(cache.mtx);
+	cache.clear();
+}
+
+/// Set the maximum number of cached plans. Zero disables the cache.
+void PatternLink::set_plan_cache_size(size_t sz)
+{
+	PlanCache& cache = plan_cache();
+	std::lock_guard<std::mutex> lck(cache.mtx);
+	cache.max_size = sz;
+	cache.trim(sz);
+}
+
+/* ================================================================= */
+
 void PatternLink::init(void)
 {
+	if (load_plan()) return;
+
 	_pat.redex_name = "anonymous PatternLink";
 	ScopeLink::extract_variables(_outgoing);
 
@@ -146,6 +555,7 @@ void PatternLink::init(void)
 	unbundle_clauses(_body);
 	common_init();
 	setup_components();
+	store_plan();
 }
 
 /* ================================================================= */
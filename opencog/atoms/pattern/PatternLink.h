@@ -74,6 +74,7 @@ namespace opencog
 ///
 /// The (cog-satisfy) and (cog-execute!) scheme calls can ground this
 /// link, and return a truth value.
+struct SearchPlan;
 class PatternLink;
 typedef std::shared_ptr<PatternLink> PatternLinkPtr;
 class PatternLink : public ScopeLink
@@ -135,6 +136,10 @@ protected:
 	void common_init(void);
 	void setup_components(void);
 
+	// Compiled-plan cache; see below.
+	bool load_plan(void);
+	void store_plan(void);
+
 protected:
 	// utility debug print
 	static void prt(const Handle& h)
@@ -168,12 +173,71 @@ public:
 	// Return the list of fixed and virtual clauses we are holding.
 	const HandleSeq& get_fixed(void) const { return _fixed; }
 	const HandleSeq& get_virtual(void) const { return _virtual; }
+	size_t get_num_comps(void) const { return _num_comps; }
 
 	bool satisfy(PatternMatchCallback&) const;
 
+	/// Describe how satisfy() would search for groundings, without
+	/// performing the search.
+	SearchPlan explain(PatternMatchCallback&) const;
+
+	/// Same as satisfy(), but start the search at the given clause,
+	/// with the given groundings of it as the only candidates.
+	bool satisfy_from(PatternMatchCallback&, const Handle& clause,
+	                  const HandleSeq& groundings) const;
+
 	void debug_log(void) const;
 
 	static Handle factory(const Handle&);
+
+	/// Compiled-plan cache. Rule engines construct the same pattern
+	/// over and over (e.g. each time a rule is copied into a scratch
+	/// atomspace); the analysis done by the constructors (variable
+	/// extraction, clause unbundling, connectivity, term trees) is
+	/// then repeated for nothing. So the analyzed pattern is cached,
+	/// keyed by a hash of the outgoing set that ignores the names of
+	/// the variables, and is copied into any later PatternLink of the
+	/// same type with the same outgoing atoms.  A pattern that is the
+	/// same up to the names of its variables (e.g. a rule that was
+	/// alpha-converted) gets a copy with the atoms renamed, since the
+	/// pattern matcher compares atoms by identity; a plan for $x
+	/// cannot ground $y.  Such a copy is not made if the renaming
+	/// would reorder an unordered link; the pattern is then analyzed.
+	///
+	/// The cache holds at most `set_plan_cache_size()` plans, and
+	/// drops the least recently used one to make room. A plan is
+	/// owned by the PatternLinks made from it, and not by the cache,
+	/// so that the cache keeps no atoms alive; once those links are
+	/// gone, so is the plan.
+	///
+	/// Patterns containing DefinedPredicateNodes are analyzed at
+	/// search time, not here, so changing a DefineLink cannot make
+	/// a cached plan stale.  Everything else in a plan depends only
+	/// on the pattern itself, and on the type hierarchy; the cache is
+	/// cleared whenever a new atom type is added. Use
+	/// `clear_plan_cache()` to drop all plans explicitly.
+	struct Plan;
+	struct PlanCacheStats
+	{
+		size_t hits;        // includes the alpha_hits
+		size_t alpha_hits;  // copies renamed from an equivalent plan
+		size_t misses;
+		size_t size;
+
+		double hit_rate(void) const
+		{
+			size_t total = hits + misses;
+			return 0 == total ? 0.0 : ((double) hits) / total;
+		}
+	};
+	static PlanCacheStats plan_cache_stats(void);
+	static void clear_plan_cache(void);
+	static void set_plan_cache_size(size_t);
+
+private:
+	// The plan this pattern was analyzed into, or copied from, if it
+	// is cached.
+	std::shared_ptr<const Plan> _plan;
 };
 
 static inline PatternLinkPtr PatternLinkCast(const Handle& h)
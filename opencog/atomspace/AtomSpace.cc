@@ -398,6 +398,28 @@ Handle AtomSpace::fetch_incoming_by_type(Handle h, Type t)
     return h;
 }
 
+IncomingSet AtomSpace::get_incoming_by_position(const Handle& h,
+                                                Type type, Arity pos) const
+{
+    IncomingSet iset;
+    if (_atom_table.positionIndexed()) {
+        HandleSeq hs;
+        _atom_table.getIncomingByPosition(std::back_inserter(hs), h, type, pos);
+        for (const Handle& l : hs)
+            iset.emplace_back(LinkCast(l));
+        return iset;
+    }
+
+    HandleSeq hs;
+    h->getIncomingSetByType(std::back_inserter(hs), type);
+    for (const Handle& l : hs) {
+        if (pos < l->getArity() and l->getOutgoingAtom(pos) == h
+            and _atom_table.in_environ(l))
+            iset.emplace_back(LinkCast(l));
+    }
+    return iset;
+}
+
 bool AtomSpace::remove_atom(Handle h, bool recursive)
 {
     if (_backing_store) {
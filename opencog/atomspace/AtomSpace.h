@@ -503,6 +503,99 @@ public:
         return _atom_table.getHandlesByType(result, type, subclass);
     }
 
+    /**
+     * Gets the nodes of the given type (subclasses optionally) whose
+     * names start with the given prefix. The nodes of each type are
+     * appended in name order.
+     *
+     * Example of call to this method, which would return all WordNodes
+     * starting with "pre":
+     * @code
+     *         HandleSeq words;
+     *         atomSpace.get_handles_by_name_prefix(words, WORD_NODE, "pre");
+     * @endcode
+     */
+    void get_handles_by_name_prefix(HandleSeq& appendToHandles,
+                                    Type type,
+                                    const std::string& prefix,
+                                    bool subclass = false) const
+    {
+        _atom_table.getHandlesByNamePrefix(back_inserter(appendToHandles),
+                                           type, prefix, subclass);
+    }
+
+    /**
+     * Gets the nodes of the given type (subclasses optionally) whose
+     * names lie in the half-open range [lo, hi), in name order for
+     * each type.
+     */
+    void get_handles_by_name_range(HandleSeq& appendToHandles,
+                                   Type type,
+                                   const std::string& lo,
+                                   const std::string& hi,
+                                   bool subclass = false) const
+    {
+        _atom_table.getHandlesByNameRange(back_inserter(appendToHandles),
+                                          type, lo, hi, subclass);
+    }
+
+    /**
+     * Gets the nodes of the given type (subclasses optionally) whose
+     * names contain the given string, in no particular order. Unless
+     * enable_name_substrings() was called, this looks at every name
+     * of those types.
+     */
+    void get_handles_by_name_substring(HandleSeq& appendToHandles,
+                                       Type type,
+                                       const std::string& str,
+                                       bool subclass = false) const
+    {
+        _atom_table.getHandlesByNameSubstring(back_inserter(appendToHandles),
+                                              type, str, subclass);
+    }
+
+    /**
+     * Keep (or drop) a trigram index of the node names, to speed up
+     * get_handles_by_name_substring() for strings of three or more
+     * characters.
+     */
+    void enable_name_substrings(bool on = true)
+    {
+        _atom_table.enableNameSubstrings(on);
+    }
+
+    /**
+     * Keep (or drop) an index of the links of each type that hold a
+     * given atom at a given position, to speed up
+     * get_incoming_by_position().
+     */
+    void enable_position_index(bool on = true)
+    {
+        _atom_table.enablePositionIndex(on);
+    }
+
+    /// True if get_incoming_by_position() is served from the index.
+    bool has_position_index(void) const
+    {
+        return _atom_table.positionIndexed();
+    }
+
+    /**
+     * Gets the links of the given type, in this atomspace or in its
+     * environment, that hold the atom `h` at position `pos` of their
+     * outgoing set.  Unless enable_position_index() was called, this
+     * looks at every link of that type in the incoming set of `h`.
+     *
+     * Example of call to this method, which would return all
+     * EvaluationLinks having the predicate p as their first atom:
+     * @code
+     *         IncomingSet evs =
+     *             atomSpace.get_incoming_by_position(p, EVALUATION_LINK, 0);
+     * @endcode
+     */
+    IncomingSet get_incoming_by_position(const Handle& h,
+                                         Type type, Arity pos) const;
+
     /* ----------------------------------------------------------- */
     /* The foreach routines offer an alternative interface
      * to the getHandleSet API.
@@ -553,6 +646,32 @@ public:
     {
         return _atom_table.TVChangedSignal().connect(function);
     }
+
+    /**
+     * Ask to be told when the value stored under `key` changes.
+     * Unlike the signals above, delivery is asynchronous and batched:
+     * the callback runs on a background thread, at most once per
+     * flush interval, with the set of atoms whose value changed since
+     * the last delivery. If `t` is not NOTYPE, only atoms of that type
+     * (or its subtypes, if `subclass` is set) are reported.
+     */
+    SubscriptionId subscribe_value(const Handle& key, ValueChangeCallback cb,
+                                   Type t = NOTYPE, bool subclass = true)
+    {
+        return _value_table.notifier().subscribe(key, cb, t, subclass);
+    }
+    void unsubscribe_value(SubscriptionId id)
+    {
+        _value_table.notifier().unsubscribe(id);
+    }
+    void set_value_flush_interval(std::chrono::milliseconds ms)
+    {
+        _value_table.notifier().set_flush_interval(ms);
+    }
+    void flush_value_notifications()
+    {
+        _value_table.notifier().flush();
+    }
 };
 
 /** @}*/
@@ -27,6 +27,7 @@
 
 #include "AtomTable.h"
 
+#include <algorithm>
 #include <atomic>
 #include <iterator>
 #include <mutex>
@@ -529,6 +530,8 @@ void AtomTable::put_atom_into_index(const AtomPtr& atom)
     std::unique_lock<std::recursive_mutex> lck(_mtx);
     Atom* pat = atom.operator->();
     typeIndex.insertAtom(pat);
+    if (atom->isNode()) nodeIndex.insertAtom(pat);
+    else if (positionIndex) positionIndex->insertAtom(pat);
 
     // We can now unlock, since we are done. In particular, the signals
     // need to run unlocked, since they may result in more atom table
@@ -763,6 +766,8 @@ AtomPtrSet AtomTable::extract(Handle& handle, bool recursive)
 
     Atom* pat = atom.operator->();
     typeIndex.removeAtom(pat);
+    if (atom->isNode()) nodeIndex.removeAtom(pat);
+    else if (positionIndex) positionIndex->removeAtom(pat);
 
     if (atom->isLink()) {
         LinkPtr lll(LinkCast(atom));
@@ -781,6 +786,24 @@ AtomPtrSet AtomTable::extract(Handle& handle, bool recursive)
     return result;
 }
 
+void AtomTable::enablePositionIndex(bool on)
+{
+    std::lock_guard<std::recursive_mutex> lck(_mtx);
+    if (not on) {
+        positionIndex.reset();
+        return;
+    }
+    if (_transient or positionIndex) return;
+
+    // Atoms still waiting in the index queue are indexed when they
+    // get out of it; the rest must be indexed here.
+    positionIndex.reset(new PositionIndex());
+    std::for_each(typeIndex.begin(LINK, true), typeIndex.end(),
+        [&](const Handle& h)->void {
+            positionIndex->insertAtom(h.operator->());
+        });
+}
+
 // This is the resize callback, when a new type is dynamically added.
 void AtomTable::typeAdded(Type t)
 {
@@ -789,5 +812,6 @@ void AtomTable::typeAdded(Type t)
     size_t new_size = classserver().getNumberOfClasses();
     _size_by_type.resize(new_size);
     typeIndex.resize();
+    nodeIndex.resize();
 }
 
@@ -26,6 +26,7 @@
 #define _OPENCOG_ATOMTABLE_H
 
 #include <iostream>
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -40,6 +41,8 @@
 #include <opencog/atoms/base/Quotation.h>
 #include <opencog/atoms/base/ClassServer.h>
 
+#include <opencog/atomspace/NodeIndex.h>
+#include <opencog/atomspace/PositionIndex.h>
 #include <opencog/atomspace/TypeIndex.h>
 
 class AtomTableUTest;
@@ -99,6 +102,8 @@ private:
     //!@{
     //! Index for quick retrieval of certain kinds of atoms.
     TypeIndex typeIndex;
+    NodeIndex nodeIndex;
+    std::unique_ptr<PositionIndex> positionIndex;
 
     async_caller<AtomTable, AtomPtr> _index_queue;
     void put_atom_into_index(const AtomPtr&);
@@ -277,6 +282,110 @@ public:
         opencog::setting_omp(opencog::num_threads());
     }
 
+    /**
+     * Returns the nodes of a given type (subclasses optionally) whose
+     * names start with the given prefix. The nodes of each type come
+     * in name order.
+     */
+    template <typename OutputIterator> OutputIterator
+    getHandlesByNamePrefix(OutputIterator result,
+                           Type type,
+                           const std::string& prefix,
+                           bool subclass = false,
+                           bool parent = true) const
+    {
+        std::lock_guard<std::recursive_mutex> lck(_mtx);
+        if (parent && _environ)
+            result = _environ->getHandlesByNamePrefix(result, type, prefix,
+                                                      subclass, parent);
+        return nodeIndex.getHandlesByPrefix(result, type, prefix, subclass);
+    }
+
+    /**
+     * Returns the nodes of a given type (subclasses optionally) whose
+     * names lie in the half-open range [lo, hi).
+     */
+    template <typename OutputIterator> OutputIterator
+    getHandlesByNameRange(OutputIterator result,
+                          Type type,
+                          const std::string& lo,
+                          const std::string& hi,
+                          bool subclass = false,
+                          bool parent = true) const
+    {
+        std::lock_guard<std::recursive_mutex> lck(_mtx);
+        if (parent && _environ)
+            result = _environ->getHandlesByNameRange(result, type, lo, hi,
+                                                     subclass, parent);
+        return nodeIndex.getHandlesByRange(result, type, lo, hi, subclass);
+    }
+
+    /**
+     * Returns the nodes of a given type (subclasses optionally) whose
+     * names contain the given string. This is fast only if the
+     * substring index was enabled; see enableNameSubstrings().
+     */
+    template <typename OutputIterator> OutputIterator
+    getHandlesByNameSubstring(OutputIterator result,
+                              Type type,
+                              const std::string& str,
+                              bool subclass = false,
+                              bool parent = true) const
+    {
+        std::lock_guard<std::recursive_mutex> lck(_mtx);
+        if (parent && _environ)
+            result = _environ->getHandlesByNameSubstring(result, type, str,
+                                                         subclass, parent);
+        return nodeIndex.getHandlesBySubstring(result, type, str, subclass);
+    }
+
+    /**
+     * Keep (or drop) a trigram index of node names, for substring
+     * lookups. It costs several index entries per node.
+     */
+    void enableNameSubstrings(bool on) {
+        std::lock_guard<std::recursive_mutex> lck(_mtx);
+        nodeIndex.enableSubstrings(on);
+    }
+
+    /**
+     * Keep (or drop) an index of the links of each type that hold a
+     * given atom at a given position. It costs one index entry per
+     * outgoing atom of every link. Transient tables keep no indexes,
+     * and ignore this.
+     */
+    void enablePositionIndex(bool on);
+
+    /**
+     * Return true if this table, and every table in its environment,
+     * keeps the position index; only then can getIncomingByPosition()
+     * be used.
+     */
+    bool positionIndexed() const
+    {
+        std::lock_guard<std::recursive_mutex> lck(_mtx);
+        if (nullptr == positionIndex) return false;
+        return nullptr == _environ or _environ->positionIndexed();
+    }
+
+    /**
+     * Returns the links of the given type that hold `h` at position
+     * `pos` of their outgoing set. The position index must have been
+     * enabled; see positionIndexed().
+     */
+    template <typename OutputIterator> OutputIterator
+    getIncomingByPosition(OutputIterator result,
+                          const Handle& h, Type type, Arity pos,
+                          bool parent = true) const
+    {
+        std::lock_guard<std::recursive_mutex> lck(_mtx);
+        if (parent && _environ)
+            result = _environ->getIncomingByPosition(result, h, type, pos,
+                                                     parent);
+        if (nullptr == positionIndex) return result;
+        return positionIndex->getIncoming(result, h.operator->(), type, pos);
+    }
+
     /* Exposes the type iterators so we can do more complicated 
      * looping without having to create a vector to hold the handles.
      *
@@ -43,6 +43,21 @@ size_t NodeIndex::size() const
 	return cnt;
 }
 
+void NodeIndex::enableSubstrings(bool on)
+{
+	if (not on)
+	{
+		trigrams.reset();
+		return;
+	}
+	if (trigrams) return;
+
+	trigrams.reset(new TrigramIndex());
+	for (const NameIndex& ni : idx)
+		for (const auto& pr : ni)
+			trigrams->insertAtom(pr.second);
+}
+
 UnorderedHandleSet NodeIndex::getHandleSet(Type type, const std::string& name,
 		bool subclass) const
 {
@@ -22,11 +22,14 @@
 #ifndef _OPENCOG_NODEINDEX_H
 #define _OPENCOG_NODEINDEX_H
 
+#include <memory>
 #include <set>
 #include <vector>
 
+#include <opencog/atoms/base/ClassServer.h>
 #include <opencog/atoms/base/types.h>
 #include <opencog/atomspace/NameIndex.h>
+#include <opencog/atomspace/TrigramIndex.h>
 
 namespace opencog
 {
@@ -37,12 +40,25 @@ namespace opencog
 /**
  * Implements an (type, name) index array of RB-trees (C++ set)
  * That is, given only the type and name of an atom, this will
- * return the corresponding handle of that atom.
+ * return the corresponding handle of that atom. Since the names
+ * of each type are kept in order, the nodes whose names start with
+ * some prefix, or lie in some range, can be found as well.
+ *
+ * Nodes whose names contain a given string can be found by looking
+ * at every name; or, if enableSubstrings() was called, through a
+ * TrigramIndex.
  */
 class NodeIndex
 {
 	private:
 		std::vector<NameIndex> idx;
+		std::unique_ptr<TrigramIndex> trigrams;
+
+		bool wanted(Type s, Type type, bool subclass) const
+		{
+			return s == type or
+				(subclass and classserver().isA(s, type));
+		}
 
 	public:
 		NodeIndex();
@@ -51,15 +67,21 @@ class NodeIndex
 		{
 			NameIndex &ni(idx[a->getType()]);
 			ni.insertAtom(a);
+			if (trigrams) trigrams->insertAtom(a);
 		}
 		void removeAtom(Atom* a)
 		{
 			NameIndex &ni(idx.at(a->getType()));
 			ni.removeAtom(a);
+			if (trigrams) trigrams->removeAtom(a);
 		}
 		void resize();
 		size_t size() const;
 
+		/// Start (or stop) keeping a TrigramIndex of the names.
+		void enableSubstrings(bool);
+		bool substringsEnabled() const { return nullptr != trigrams; }
+
 		Atom* getAtom(Type type, const std::string& str) const
 		{
 			const NameIndex &ni(idx.at(type));
@@ -89,6 +111,54 @@ class NodeIndex
 			}
 			return result;
 		}
+
+		/// The nodes whose names start with `prefix`, in name order
+		/// for each type.
+		template <typename OutputIterator> OutputIterator
+		getHandlesByPrefix(OutputIterator result, Type type,
+		                   const std::string& prefix, bool subclass) const
+		{
+			Type max = idx.size();
+			for (Type s = 0; s < max; s++)
+				if (wanted(s, type, subclass))
+					result = idx[s].get_prefix(result, prefix);
+			return result;
+		}
+
+		/// The nodes whose names lie in [lo, hi), in name order for
+		/// each type.
+		template <typename OutputIterator> OutputIterator
+		getHandlesByRange(OutputIterator result, Type type,
+		                  const std::string& lo, const std::string& hi,
+		                  bool subclass) const
+		{
+			Type max = idx.size();
+			for (Type s = 0; s < max; s++)
+				if (wanted(s, type, subclass))
+					result = idx[s].get_range(result, lo, hi);
+			return result;
+		}
+
+		/// The nodes whose names contain `str`, in no particular order.
+		template <typename OutputIterator> OutputIterator
+		getHandlesBySubstring(OutputIterator result, Type type,
+		                      const std::string& str, bool subclass) const
+		{
+			if (trigrams and TrigramIndex::usable(str))
+			{
+				for (Atom* a : trigrams->candidates(str))
+					if (wanted(a->getType(), type, subclass) and
+					    std::string::npos != a->getName().find(str))
+						*result++ = a->getHandle();
+				return result;
+			}
+
+			Type max = idx.size();
+			for (Type s = 0; s < max; s++)
+				if (wanted(s, type, subclass))
+					result = idx[s].get_substring(result, str);
+			return result;
+		}
 };
 
 /** @}*/
@@ -0,0 +1,52 @@
+/*
+ * opencog/atomspace/PositionIndex.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <opencog/atomspace/PositionIndex.h>
+
+using namespace opencog;
+
+void PositionIndex::insertAtom(Atom* a)
+{
+	if (not a->isLink()) return;
+	Type t = a->getType();
+	const HandleSeq& oset = a->getOutgoingSet();
+	Arity arity = oset.size();
+	for (Arity i = 0; i < arity; i++)
+		idx[{oset[i].operator->(), t, i}].insert(a);
+}
+
+void PositionIndex::removeAtom(Atom* a)
+{
+	if (not a->isLink()) return;
+	Type t = a->getType();
+	const HandleSeq& oset = a->getOutgoingSet();
+	Arity arity = oset.size();
+	for (Arity i = 0; i < arity; i++)
+	{
+		auto it = idx.find({oset[i].operator->(), t, i});
+		if (idx.end() == it) continue;
+		it->second.erase(a);
+		if (it->second.empty()) idx.erase(it);
+	}
+}
+
+// ================================================================
@@ -0,0 +1,102 @@
+/*
+ * opencog/atomspace/PositionIndex.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef _OPENCOG_POSITIONINDEX_H
+#define _OPENCOG_POSITIONINDEX_H
+
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <opencog/atoms/base/Atom.h>
+#include <opencog/atoms/base/types.h>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/**
+ * Implements a map from (atom, link type, position) to the links of
+ * that type that hold the atom at that position in their outgoing
+ * set. This is a slice of the incoming set of the atom; for an atom
+ * with millions of incoming links, of which only a few are of the
+ * wanted type and have the atom in the wanted place, the slice can
+ * be had without looking at the rest.
+ *
+ * This costs one entry per outgoing atom of every link, and so it is
+ * only kept if asked for; see AtomTable::enablePositionIndex().
+ */
+class PositionIndex
+{
+	private:
+		struct Key
+		{
+			Atom* target;
+			Type type;
+			Arity pos;
+			bool operator==(const Key& k) const
+			{
+				return target == k.target and type == k.type and pos == k.pos;
+			}
+		};
+		struct KeyHash
+		{
+			size_t operator()(const Key& k) const
+			{
+				size_t h = std::hash<Atom*>()(k.target);
+				h ^= (size_t(k.type) << 16 | k.pos) + 0x9e3779b9 + (h << 6) + (h >> 2);
+				return h;
+			}
+		};
+
+		std::unordered_map<Key, std::unordered_set<Atom*>, KeyHash> idx;
+
+	public:
+		void insertAtom(Atom*);
+		void removeAtom(Atom*);
+		void clear(void) { idx.clear(); }
+
+		/// The links of type `type` having `a` at position `pos`.
+		template <typename OutputIterator> OutputIterator
+		getIncoming(OutputIterator result, Atom* a, Type type, Arity pos) const
+		{
+			auto it = idx.find({a, type, pos});
+			if (idx.end() == it) return result;
+			for (Atom* l : it->second)
+				*result++ = l->getHandle();
+			return result;
+		}
+
+		size_t getIncomingSize(Atom* a, Type type, Arity pos) const
+		{
+			auto it = idx.find({a, type, pos});
+			if (idx.end() == it) return 0;
+			return it->second.size();
+		}
+};
+
+/** @}*/
+} //namespace opencog
+
+#endif // _OPENCOG_POSITIONINDEX_H
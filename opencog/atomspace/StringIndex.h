@@ -25,7 +25,7 @@
 #include <map>
 #include <string>
 
-#include <opencog/atoms/base/Handle.h>
+#include <opencog/atoms/base/Atom.h>
 
 namespace opencog
 {
@@ -35,7 +35,9 @@ namespace opencog
 
 /**
  * Implements map from string to atom pointers. Used to implement
- * the lookup of atoms according to thier name.
+ * the lookup of atoms according to thier name. The map is ordered,
+ * so the atoms whose names share a prefix, or fall in a range, can
+ * be found without looking at the others.
  */
 class StringIndex
 {
@@ -62,6 +64,46 @@ class StringIndex
 		{
 			return idx.size();
 		}
+
+		typedef std::map<std::string, Atom*>::const_iterator const_iterator;
+		const_iterator begin(void) const { return idx.begin(); }
+		const_iterator end(void) const { return idx.end(); }
+
+		/// The atoms whose names start with `prefix`, in name order.
+		template <typename OutputIterator> OutputIterator
+		get_prefix(OutputIterator result, const std::string& prefix) const
+		{
+			for (auto it = idx.lower_bound(prefix); it != idx.end(); it++)
+			{
+				if (0 != it->first.compare(0, prefix.size(), prefix)) break;
+				*result++ = it->second->getHandle();
+			}
+			return result;
+		}
+
+		/// The atoms whose names lie in the half-open range [lo, hi),
+		/// in name order.
+		template <typename OutputIterator> OutputIterator
+		get_range(OutputIterator result,
+		          const std::string& lo, const std::string& hi) const
+		{
+			if (hi <= lo) return result;
+			auto end = idx.lower_bound(hi);
+			for (auto it = idx.lower_bound(lo); it != end; it++)
+				*result++ = it->second->getHandle();
+			return result;
+		}
+
+		/// The atoms whose names contain `str`, in name order. This
+		/// looks at every name; see TrigramIndex for a faster way.
+		template <typename OutputIterator> OutputIterator
+		get_substring(OutputIterator result, const std::string& str) const
+		{
+			for (const auto& pr : idx)
+				if (std::string::npos != pr.first.find(str))
+					*result++ = pr.second->getHandle();
+			return result;
+		}
 };
 
 /** @}*/
@@ -0,0 +1,90 @@
+/*
+ * opencog/atomspace/TrigramIndex.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <algorithm>
+
+#include <opencog/atomspace/TrigramIndex.h>
+
+using namespace opencog;
+
+/// The distinct trigrams of a string, each packed into an integer.
+std::vector<uint32_t> TrigramIndex::trigrams(const std::string& str)
+{
+	std::vector<uint32_t> grams;
+	for (size_t i = 0; i + 3 <= str.size(); i++)
+	{
+		const unsigned char* p = (const unsigned char*) &str[i];
+		grams.push_back((p[0] << 16) | (p[1] << 8) | p[2]);
+	}
+	std::sort(grams.begin(), grams.end());
+	grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+	return grams;
+}
+
+void TrigramIndex::insertAtom(Atom* a)
+{
+	if (not a->isNode()) return;
+	for (uint32_t g : trigrams(a->getName()))
+		idx[g].insert(a);
+}
+
+void TrigramIndex::removeAtom(Atom* a)
+{
+	if (not a->isNode()) return;
+	for (uint32_t g : trigrams(a->getName()))
+	{
+		auto it = idx.find(g);
+		if (idx.end() == it) continue;
+		it->second.erase(a);
+		if (it->second.empty()) idx.erase(it);
+	}
+}
+
+std::vector<Atom*> TrigramIndex::candidates(const std::string& str) const
+{
+	std::vector<Atom*> result;
+	if (not usable(str)) return result;
+
+	// Start from the rarest trigram, and check the others against it.
+	std::vector<const std::unordered_set<Atom*>*> sets;
+	for (uint32_t g : trigrams(str))
+	{
+		auto it = idx.find(g);
+		if (idx.end() == it) return result;
+		sets.push_back(&it->second);
+	}
+	std::sort(sets.begin(), sets.end(),
+		[](const std::unordered_set<Atom*>* a,
+		   const std::unordered_set<Atom*>* b)
+		{ return a->size() < b->size(); });
+
+	for (Atom* a : *sets[0])
+	{
+		bool all = true;
+		for (size_t i = 1; all and i < sets.size(); i++)
+			all = 0 < sets[i]->count(a);
+		if (all) result.push_back(a);
+	}
+	return result;
+}
+
+// ================================================================
@@ -0,0 +1,77 @@
+/*
+ * opencog/atomspace/TrigramIndex.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef _OPENCOG_TRIGRAMINDEX_H
+#define _OPENCOG_TRIGRAMINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <opencog/atoms/base/Atom.h>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/**
+ * Implements a map from the three-letter substrings (trigrams) of node
+ * names to the nodes. Every node whose name contains a string also
+ * contains all of the trigrams of that string; so intersecting their
+ * entries gives a short list of candidates, which then only need to be
+ * checked. Strings shorter than three letters have no trigrams, and
+ * cannot be looked up this way.
+ *
+ * This costs several entries per node, and so it is only kept if asked
+ * for; see NodeIndex::enableSubstrings().
+ */
+class TrigramIndex
+{
+	private:
+		std::unordered_map<uint32_t, std::unordered_set<Atom*>> idx;
+
+		static std::vector<uint32_t> trigrams(const std::string&);
+
+	public:
+		void insertAtom(Atom*);
+		void removeAtom(Atom*);
+		void clear(void) { idx.clear(); }
+
+		/// True if strings of this length can be looked up.
+		static bool usable(const std::string& str)
+		{
+			return 3 <= str.size();
+		}
+
+		/// The atoms whose names have every trigram of `str`. This
+		/// is a superset of the atoms whose names contain `str`.
+		std::vector<Atom*> candidates(const std::string& str) const;
+};
+
+/** @}*/
+} //namespace opencog
+
+#endif // _OPENCOG_TRIGRAMINDEX_H
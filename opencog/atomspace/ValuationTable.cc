@@ -59,6 +59,10 @@ void ValuationTable::addValuation(const ValuationPtr& vp)
 
 	// Record the actual valuation
 	_vindex[std::make_pair(key, atom)] = vp;
+
+	// Tell anyone who cares. This is a single atomic load if no one
+	// is watching this key; callbacks are never run from here.
+	_notifier.changed(key, atom);
 }
 
 /// Associate a value with a particular (key,atom) pair
@@ -29,6 +29,7 @@
 
 #include <opencog/atoms/base/Handle.h>
 #include <opencog/atoms/base/Valuation.h>
+#include <opencog/atomspace/ValueNotifier.h>
 
 namespace opencog
 {
@@ -54,6 +55,9 @@ private:
 	std::unordered_map<HandlePair, ValuationPtr> _vindex;
 	std::unordered_map<Handle, HandleSet> _keyset;
 
+	// Subscribers that want to hear about changes to specific keys.
+	ValueNotifier _notifier;
+
 	/**
 	 * Override and declare copy constructor and equals operator as
 	 * private.  This is to prevent large object copying by mistake.
@@ -72,6 +76,8 @@ public:
 	ProtoAtomPtr getValue(const Handle&, const Handle&);
 
 	HandleSet getKeys(const Handle&);
+
+	ValueNotifier& notifier() { return _notifier; }
 };
 
 /** @}*/
@@ -0,0 +1,199 @@
+/*
+ * opencog/atomspace/ValueNotifier.cc
+ *
+ * Copyright (C) 2017 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include <opencog/util/Logger.h>
+#include <opencog/atoms/base/Atom.h>
+#include <opencog/atoms/base/ClassServer.h>
+
+#include "ValueNotifier.h"
+
+using namespace opencog;
+
+ValueNotifier::ValueNotifier()
+	: _next_id(1), _key_mask(0), _interval(100), _stop(false),
+	  _delivering(0)
+{
+}
+
+ValueNotifier::~ValueNotifier()
+{
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		_stop = true;
+	}
+	_cv.notify_all();
+	if (_flusher.joinable()) _flusher.join();
+}
+
+void ValueNotifier::rebuild_mask()
+{
+	uint64_t mask = 0;
+	for (const auto& pr : _by_key)
+		mask |= key_bit(pr.first);
+	_key_mask.store(mask, std::memory_order_relaxed);
+}
+
+/// Slow path: someone is watching a key that hashes like this one.
+void ValueNotifier::record(const Handle& key, const Handle& atom)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+
+	auto ki = _by_key.find(key);
+	if (_by_key.end() == ki) return;
+
+	Type at = atom->getType();
+	for (SubscriptionId id : ki->second)
+	{
+		Subscription& sub = _subs[id];
+		if (NOTYPE != sub.type and at != sub.type and
+		    (not sub.subclass or not classserver().isA(at, sub.type)))
+			continue;
+		sub.pending.insert(atom);
+	}
+}
+
+SubscriptionId ValueNotifier::subscribe(const Handle& key,
+                                        ValueChangeCallback cb,
+                                        Type t, bool subclass)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+
+	SubscriptionId id = _next_id++;
+	Subscription& sub = _subs[id];
+	sub.key = key;
+	sub.type = t;
+	sub.subclass = subclass;
+	sub.callback = cb;
+
+	_by_key[key].push_back(id);
+	rebuild_mask();
+
+	if (not _flusher.joinable())
+		_flusher = std::thread(&ValueNotifier::flush_loop, this);
+
+	return id;
+}
+
+void ValueNotifier::unsubscribe(SubscriptionId id)
+{
+	std::unique_lock<std::mutex> lck(_mtx);
+
+	auto si = _subs.find(id);
+	if (_subs.end() == si) return;
+
+	std::vector<SubscriptionId>& ids = _by_key[si->second.key];
+	ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+	if (ids.empty()) _by_key.erase(si->second.key);
+
+	_subs.erase(si);
+	rebuild_mask();
+
+	// A callback may unsubscribe itself; don't wait for ourselves.
+	if (std::this_thread::get_id() == _deliverer) return;
+	_delivered.wait(lck, [&] { return _delivering != id; });
+}
+
+void ValueNotifier::set_flush_interval(std::chrono::milliseconds ms)
+{
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		_interval = ms;
+	}
+	_cv.notify_all();
+}
+
+void ValueNotifier::flush()
+{
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		if (std::this_thread::get_id() == _deliverer) return;
+	}
+	std::lock_guard<std::mutex> flck(_flush_mtx);
+
+	// Grab everything that is pending, and then run the callbacks
+	// without holding the lock, so that they can (un-)subscribe, or
+	// change more values.
+	std::vector<std::pair<SubscriptionId, std::pair<Handle, HandleSeq>>> batch;
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		for (auto& pr : _subs)
+		{
+			Subscription& sub = pr.second;
+			if (sub.pending.empty()) continue;
+			HandleSeq atoms(sub.pending.begin(), sub.pending.end());
+			sub.pending.clear();
+			batch.push_back({pr.first, {sub.key, atoms}});
+		}
+		_deliverer = std::this_thread::get_id();
+	}
+
+	for (const auto& b : batch)
+	{
+		// Skip subscriptions dropped by an earlier callback, or by
+		// another thread, since the batch was put together.
+		ValueChangeCallback cb;
+		{
+			std::lock_guard<std::mutex> lck(_mtx);
+			auto si = _subs.find(b.first);
+			if (_subs.end() == si) continue;
+			cb = si->second.callback;
+			_delivering = b.first;
+		}
+
+		try
+		{
+			cb(b.second.first, b.second.second);
+		}
+		catch (const std::exception& ex)
+		{
+			logger().warn("Value-change callback threw: %s", ex.what());
+		}
+		catch (...)
+		{
+			logger().warn("Value-change callback threw");
+		}
+
+		{
+			std::lock_guard<std::mutex> lck(_mtx);
+			_delivering = 0;
+		}
+		_delivered.notify_all();
+	}
+
+	std::lock_guard<std::mutex> lck(_mtx);
+	_deliverer = std::thread::id();
+}
+
+void ValueNotifier::flush_loop()
+{
+	std::unique_lock<std::mutex> lck(_mtx);
+	while (not _stop)
+	{
+		_cv.wait_for(lck, _interval);
+		if (_stop) break;
+		lck.unlock();
+		flush();
+		lck.lock();
+	}
+}
@@ -0,0 +1,146 @@
+/*
+ * opencog/atomspace/ValueNotifier.h
+ *
+ * Copyright (C) 2017 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_VALUE_NOTIFIER_H
+#define _OPENCOG_VALUE_NOTIFIER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <opencog/atoms/base/Handle.h>
+#include <opencog/atoms/base/types.h>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/// Callback invoked with the key, and the set of atoms whose value
+/// under that key changed since the last flush.
+typedef std::function<void (const Handle&, const HandleSeq&)> ValueChangeCallback;
+typedef unsigned long SubscriptionId;
+
+/**
+ * Deliver asynchronous, batched notifications of value changes to
+ * subscribers that have asked about specific keys.
+ *
+ * The cost of a value change on a key that no one is watching is a
+ * single atomic load: a 64-bit mask of the hashes of the watched keys
+ * is checked before taking any locks. Changes on watched keys are
+ * recorded in a per-subscription set, so that repeated updates to the
+ * same atom are coalesced. A background thread flushes these sets
+ * every flush interval, so that each subscriber is told about each
+ * atom at most once per interval.  Callbacks run on the flush thread,
+ * never on the thread that changed the value.
+ */
+class ValueNotifier
+{
+private:
+	struct Subscription
+	{
+		Handle key;
+		Type type;             // NOTYPE means "any atom type"
+		bool subclass;
+		ValueChangeCallback callback;
+		UnorderedHandleSet pending;
+	};
+
+	// Lock protecting the subscriptions and the pending sets.
+	mutable std::mutex _mtx;
+
+	SubscriptionId _next_id;
+	std::map<SubscriptionId, Subscription> _subs;
+	std::unordered_map<Handle, std::vector<SubscriptionId>> _by_key;
+
+	// Bloom-style mask of watched keys; zero when no one is watching.
+	std::atomic<uint64_t> _key_mask;
+	static uint64_t key_bit(const Handle& key)
+		{ return ((uint64_t) 1) << (key.value() % 64); }
+	void rebuild_mask();
+
+	// The flush thread; started on first subscription.  The interval
+	// is protected by _mtx.
+	std::chrono::milliseconds _interval;
+	std::thread _flusher;
+	std::condition_variable _cv;
+	bool _stop;
+	void flush_loop();
+
+	// Only one flush at a time delivers callbacks.  While it does,
+	// _deliverer is its thread, and _delivering is the subscription
+	// whose callback is running (zero if none); unsubscribe() waits
+	// on _delivered until that callback is done.  Both are protected
+	// by _mtx.
+	std::mutex _flush_mtx;
+	std::thread::id _deliverer;
+	SubscriptionId _delivering;
+	std::condition_variable _delivered;
+
+	ValueNotifier(const ValueNotifier&);
+	ValueNotifier& operator=(const ValueNotifier&);
+
+public:
+	ValueNotifier();
+	~ValueNotifier();
+
+	/// Report that the value on `atom` under `key` has changed.
+	/// Cheap and non-blocking when no one is watching `key`.
+	void changed(const Handle& key, const Handle& atom)
+	{
+		if (0 == (_key_mask.load(std::memory_order_relaxed) & key_bit(key)))
+			return;
+		record(key, atom);
+	}
+	void record(const Handle& key, const Handle& atom);
+
+	/// Subscribe to changes of the value stored under `key`.  If
+	/// `t` is not NOTYPE, then only atoms of that type (or of its
+	/// subtypes, if `subclass` is set) are reported.
+	SubscriptionId subscribe(const Handle& key, ValueChangeCallback,
+	                         Type t = NOTYPE, bool subclass = true);
+
+	/// Stop delivering notifications to the subscription.  If its
+	/// callback is running on another thread, wait for it to return,
+	/// so that the callback is never called once this returns.  Safe
+	/// to call from within a callback.
+	void unsubscribe(SubscriptionId);
+
+	/// Set how often pending notifications are delivered.
+	void set_flush_interval(std::chrono::milliseconds);
+
+	/// Deliver all pending notifications now, on the calling thread.
+	/// Flushes are serialised: this waits for any flush that is in
+	/// progress.  Called from within a callback, it does nothing.
+	void flush();
+};
+
+/** @}*/
+} //namespace opencog
+
+#endif // _OPENCOG_VALUE_NOTIFIER_H
@@ -87,3 +87,21 @@ RankedHandleSeq FuzzyMatch::perform_search(const Handle& target)
 	// Give the derived class a chance to wrap things up.
 	return finished_search();
 }
+
+/**
+ * Score the given candidate trees, instead of searching for them.
+ * The scoring is the same as in the search above.
+ *
+ * @param target      The target pattern.
+ * @param candidates  The trees to be scored against it.
+ */
+RankedHandleSeq FuzzyMatch::perform_search(const Handle& target,
+                                           const HandleSeq& candidates)
+{
+	start_search(target);
+
+	for (const Handle& h : candidates)
+		try_match(h);
+
+	return finished_search();
+}
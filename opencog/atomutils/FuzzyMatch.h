@@ -70,6 +70,12 @@ namespace opencog
  * true, then larger and larger trees holding the starter are proposed.
  * If it returns false, then the proposal of the ever-larger trees
  * halts.
+ *
+ * On a large atomspace, the incoming sets of common leaves are huge,
+ * and this search touches most of it. If the candidate trees can be
+ * found some other way (e.g. from a SimilarityIndex, in the query
+ * library), then `perform_search()` can be given them, and will only
+ * score those.
  */
 
 typedef std::vector<std::pair<Handle, double>> RankedHandleSeq;
@@ -78,6 +84,7 @@ class FuzzyMatch
 {
 public:
     RankedHandleSeq perform_search(const Handle&);
+    RankedHandleSeq perform_search(const Handle&, const HandleSeq&);
     virtual ~FuzzyMatch() {}
 
 protected:
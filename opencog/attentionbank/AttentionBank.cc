@@ -43,6 +43,7 @@ AttentionBank::AttentionBank(AtomSpace* asp) :
     STIAtomWage = config().get_int("ECAN_STARTING_ATOM_STI_WAGE", 10);
     LTIAtomWage = config().get_int("ECAN_STARTING_ATOM_LTI_WAGE", 10);
     minAFSize = config().get_int("ECAN_MIN_AF_SIZE", 100);
+    _af_members = std::make_shared<const UnorderedHandleSet>();
 
     _removeAtomConnection =
         asp->removeAtomSignal(
@@ -338,13 +339,22 @@ Handle AttentionBank::getRandomAtom()
 
 bool AttentionBank::atom_is_in_AF(const Handle& h)
 {
-    auto it = std::find_if(attentionalFocus.begin(), attentionalFocus.end(),
-            [h](std::pair<Handle, AttentionValuePtr> p)
-            { if(p.first == h )
-                      return true;
-               return false;
-            });
-    return  (it != attentionalFocus.end());
+    return 0 < get_af_members()->count(h);
+}
+
+/**
+ * Replace the set of AF members with one holding the current contents
+ * of the AF. Must be called with AFMutex held. The AF is small, so
+ * copying it costs little, and it happens only when an atom enters or
+ * leaves the AF, not on every change of STI.
+ */
+void AttentionBank::publish_af_members(void)
+{
+    auto members = std::make_shared<UnorderedHandleSet>();
+    members->reserve(attentionalFocus.size());
+    for (const auto& p : attentionalFocus)
+        members->insert(p.first);
+    std::atomic_store(&_af_members, AFMembersPtr(members));
 }
 
 /**
@@ -358,6 +368,8 @@ void AttentionBank::updateAttentionalFocus(const Handle& h,
     AttentionValue::sti_t sti = new_av->getSTI();
     auto least = attentionalFocus.begin(); // Atom to be removed from the AF
     bool insertable = false;
+    Handle hrm; // Atom removed from the AF, if any
+    AttentionValuePtr hrm_old_av, hrm_new_av;
     auto it = std::find_if(attentionalFocus.begin(), attentionalFocus.end(),
             [h](std::pair<Handle, AttentionValuePtr> p)
             { if(p.first == h ) return true; return false;});
@@ -373,20 +385,24 @@ void AttentionBank::updateAttentionalFocus(const Handle& h,
     // Remove the least sti valued atom in the AF and repace
     // it with the new atom holding higher STI value.
     } else if( sti > (least->second)->getSTI()){
-        Handle hrm = least->first;
-        AttentionValuePtr hrm_new_av = get_av(hrm);
+        hrm = least->first;
+        hrm_new_av = get_av(hrm);
         // Value recorded when this atom entered into AF
-        AttentionValuePtr hrm_old_av = least->second;
+        hrm_old_av = least->second;
 
         attentionalFocus.erase(least);
-        AFCHSigl& afch = RemoveAFSignal();
-        afch(hrm, hrm_old_av, hrm_new_av);
         insertable = true;
     }
 
-    // Insert the new atom in to AF and emit the AddAFSignal.
+    // Insert the new atom in to AF and emit the signals, once the
+    // new AF members are published.
     if(insertable){
         attentionalFocus.insert(std::make_pair(h, new_av));
+        publish_af_members();
+        if (hrm) {
+            AFCHSigl& afrm = RemoveAFSignal();
+            afrm(hrm, hrm_old_av, hrm_new_av);
+        }
         AFCHSigl& afch = AddAFSignal();
         afch(h, old_av, new_av);
     }
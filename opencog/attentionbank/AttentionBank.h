@@ -27,6 +27,7 @@
 #define _OPENCOG_ATTENTION_BANK_H
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
@@ -55,6 +56,9 @@ typedef boost::signals2::signal<void (const Handle&,
                                       const AttentionValuePtr&,
                                       const AttentionValuePtr&)> AFCHSigl;
 
+/* The members of the Attentional Focus, at some point in time */
+typedef std::shared_ptr<const UnorderedHandleSet> AFMembersPtr;
+
 class AtomSpace;
 class AttentionBank
 {
@@ -73,6 +77,15 @@ class AttentionBank
     };
     std::multiset<std::pair<Handle, AttentionValuePtr>, compare_sti_less> attentionalFocus;
 
+    /**
+     * The atoms in attentionalFocus, as a set that is never modified.
+     * Whenever an atom enters or leaves the AF, a new set replaces it
+     * (under AFMutex); readers fetch the current one with an atomic
+     * load, and so never wait on AFMutex.
+     */
+    AFMembersPtr _af_members;
+    void publish_af_members(void);
+
     void updateAttentionalFocus(const Handle&, const AttentionValuePtr&, 
                                 const AttentionValuePtr&);
     
@@ -352,7 +365,23 @@ public:
      */
     Handle getRandomAtom(void);
 
+    /**
+     * Return true if the atom is in the Attentional Focus. This does
+     * not take any lock; see get_af_members().
+     */
     bool atom_is_in_AF(const Handle&);
+
+    /**
+     * Return the members of the Attentional Focus. The set returned
+     * does not change, even as atoms enter or leave the AF; holding
+     * on to it gives a consistent view of the AF, e.g. for the
+     * duration of a search. Membership tests on it are O(1), and
+     * take no lock.
+     */
+    AFMembersPtr get_af_members(void) const {
+        return std::atomic_load(&_af_members);
+    }
+
     /**
      * Updates the importance index for the given atom. According to the
      * new importance of the atom, it may change importance bins.
@@ -16,6 +16,7 @@
 #include <opencog/atoms/base/Node.h>
 #include <opencog/atoms/base/Link.h>
 #include <opencog/truthvalue/AttentionValue.h>
+#include <opencog/truthvalue/CompactTruthValue.h>
 #include <opencog/truthvalue/CountTruthValue.h>
 #include <opencog/truthvalue/IndefiniteTruthValue.h>
 #include <opencog/truthvalue/SimpleTruthValue.h>
@@ -91,32 +92,43 @@ AtomSpaceBenchmark::~AtomSpaceBenchmark()
 // This is wrong, because it fails to count also the amount of RAM
 // used by the AtomTable to store indexes, as well as the AttentionBank
 // to store the AttentionValues.
+size_t AtomSpaceBenchmark::estimateOfTVSize(const TruthValuePtr& tv)
+{
+    // The shared default TV is not paid for by any single atom.
+    if (tv == TruthValue::DEFAULT_TV()) return 0;
+
+    // The compact TV keeps its floats inline; everything else keeps
+    // them in the heap-allocated vector of the FloatValue base class.
+    Type tvt = tv->getType();
+    if (tvt == COMPACT_TRUTH_VALUE)
+        return sizeof(CompactTruthValue);
+
+    size_t total = tv->value().size() * sizeof(double);
+    if (tvt == SIMPLE_TRUTH_VALUE)
+        total += sizeof(SimpleTruthValue);
+    else
+    if (tvt == COUNT_TRUTH_VALUE)
+        total += sizeof(CountTruthValue);
+    else
+    if (tvt == INDEFINITE_TRUTH_VALUE)
+        total += sizeof(IndefiniteTruthValue);
+    return total;
+}
+
 size_t AtomSpaceBenchmark::estimateOfAtomSize(Handle h)
 {
-    size_t total = 0;
-    if (h->getTruthValue() != TruthValue::DEFAULT_TV())
-    {
-        Type tvt = h->getTruthValue()->getType();
-        if (tvt == SIMPLE_TRUTH_VALUE)
-            total += sizeof(SimpleTruthValue);
-        else
-        if (tvt == COUNT_TRUTH_VALUE)
-            total += sizeof(CountTruthValue);
-        else
-        if (tvt == INDEFINITE_TRUTH_VALUE)
-            total += sizeof(IndefiniteTruthValue);
-    }
+    size_t total = estimateOfTVSize(h->getTruthValue());
 
     NodePtr n(NodeCast(h));
     if (n)
     {
-        total = sizeof(Node);
+        total += sizeof(Node);
         total += n->getName().capacity();
     }
     else
     {
         LinkPtr l(LinkCast(h));
-        total = sizeof(Link);
+        total += sizeof(Link);
         total += l->getOutgoingSet().capacity() * sizeof(Handle);
         for (Handle ho: l->getOutgoingSet())
         {
@@ -155,6 +167,7 @@ void AtomSpaceBenchmark::printTypeSizes()
     cout << "Node = " << sizeof(Node) << endl;
     cout << "Link = " << sizeof(Link) << endl;
     cout << "SimpleTruthValue = " << sizeof(SimpleTruthValue) << endl;
+    cout << "CompactTruthValue = " << sizeof(CompactTruthValue) << endl;
     cout << "CountTruthValue = " << sizeof(CountTruthValue) << endl;
     cout << "IndefiniteTruthValue = " << sizeof(IndefiniteTruthValue) << endl;
     cout << "AttentionValue = " << sizeof(AttentionValue) << endl;
@@ -179,6 +192,38 @@ void AtomSpaceBenchmark::printTypeSizes()
     cout << "ListLink with two ConceptNodes = "
          << estimateOfAtomSize(ll) << endl;
 
+    // Per-atom cost of a non-default truth value, in both flavors.
+    TruthValuePtr stv(SimpleTruthValue::createSTV(0.5, 0.5));
+    TruthValuePtr ctv(CompactTruthValue::createTV(0.5, 0.5));
+    cout << "Non-default SimpleTruthValue = "
+         << estimateOfTVSize(stv) << endl;
+    cout << "Non-default CompactTruthValue = "
+         << estimateOfTVSize(ctv) << endl;
+
+    // Time the life cycle of a TV in both flavors: create it, read
+    // it, fetch the vector (as the persistence code does), drop it.
+    static const int NTV = 1000000;
+    double sum = 0.0;
+    for (int compact = 0; compact < 2; compact++)
+    {
+        clock_t t_begin = clock();
+        for (int i = 0; i < NTV; i++)
+        {
+            strength_t s = (i % 1000) * 0.001;
+            TruthValuePtr tv(compact ?
+                CompactTruthValue::createTV(s, 0.5) :
+                std::static_pointer_cast<const TruthValue>(
+                    SimpleTruthValue::createSTV(s, 0.5)));
+            sum += tv->getMean() + tv->getConfidence() + tv->value()[0];
+        }
+        clock_t time_taken = clock() - t_begin;
+        cout << (compact ? "CompactTruthValue" : "SimpleTruthValue")
+             << " create/read/value() = "
+             << (1.0e9 * time_taken) / (CLOCKS_PER_SEC * (double) NTV)
+             << " nanosecs per TV" << endl;
+    }
+    global += sum;
+
     Handle np = ND(PREDICATE_NODE, "some predicate");
     Handle el = LK(EVALUATION_LINK, np, ll);
     cout << "EvaluationLink with two ConceptNodes = "
@@ -121,6 +121,7 @@ public:
     bool showTypeSizes;
     void printTypeSizes();
     size_t estimateOfAtomSize(Handle h);
+    size_t estimateOfTVSize(const TruthValuePtr&);
 
     AtomSpaceBenchmark();
     ~AtomSpaceBenchmark();
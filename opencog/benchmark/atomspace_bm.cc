@@ -5,6 +5,8 @@
 
 #include <cstdlib>
 
+#include <opencog/truthvalue/SimpleTruthValue.h>
+
 #include "AtomSpaceBenchmark.h"
 
 using namespace std;
@@ -40,6 +42,7 @@ int main(int argc, char** argv)
      "         \t(-p impact behaviour of -S too)\n"
      "-s <int> \tSet how many atoms are created (default: 256K)\n"
      "-d <float> \tChance of using default truth value (default: 0.8)\n"
+     "-T       \tUse single-precision CompactTruthValues for all stv's\n"
      "-- Saving data --\n"
      "-k       \tCalculate stats (warning, this will affect rss memory reporting)\n"
      "-f       \tSave a csv file with records for every repeated event\n"
@@ -56,7 +59,7 @@ int main(int argc, char** argv)
     opterr = 0;
     benchmarker.testKind = opencog::AtomSpaceBenchmark::BENCH_AS;
 
-    while ((c = getopt (argc, argv, "tAXgMCcm:ln:r:u:h:R:S:p:s:d:kfi:")) != -1) {
+    while ((c = getopt (argc, argv, "tAXgMCcm:ln:r:u:h:R:S:p:s:d:Tkfi:")) != -1) {
        switch (c)
        {
            case 't':
@@ -128,6 +131,9 @@ int main(int argc, char** argv)
            case 'd':
              benchmarker.chanceUseDefaultTV = atof(optarg);
              break;
+           case 'T':
+             opencog::SimpleTruthValue::USE_COMPACT = true;
+             break;
            case 'k':
              benchmarker.doStats = true;
              break;
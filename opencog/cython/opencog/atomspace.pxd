@@ -70,6 +70,9 @@ cdef extern from "opencog/truthvalue/SimpleTruthValue.h" namespace "opencog":
         bint operator==(cTruthValue h)
         bint operator!=(cTruthValue h)
 
+    # The same factory that cog-new-stv uses; it honours USE_COMPACT.
+    cdef tv_ptr create_simple_tv "opencog::SimpleTruthValue::createTV"(strength_t, confidence_t)
+
 
 # Basic OpenCog types
 # ClassServer
@@ -180,6 +183,12 @@ cdef extern from "opencog/atomspace/AtomSpace.h" namespace "opencog":
         # get by type
         output_iterator get_handles_by_type(output_iterator, Type t, bint subclass)
 
+        # get nodes by name
+        void get_handles_by_name_prefix(vector[cHandle]&, Type t, string prefix, bint subclass)
+        void get_handles_by_name_range(vector[cHandle]&, Type t, string lo, string hi, bint subclass)
+        void get_handles_by_name_substring(vector[cHandle]&, Type t, string s, bint subclass)
+        void enable_name_substrings(bint on)
+
         void clear()
         bint remove_atom(cHandle h, bint recursive)
 
@@ -216,6 +216,43 @@ cdef class AtomSpace:
             yield Atom(void_from_candle(current_c_handle), self)
             inc(c_handle_iter)
 
+    def get_atoms_by_name_prefix(self, Type t, prefix, subtype = False):
+        """ Return the nodes of type t whose names start with prefix,
+        in name order """
+        if self.atomspace == NULL:
+            return None
+        cdef vector[cHandle] handle_vector
+        cdef string c_prefix = prefix.encode('UTF-8')
+        self.atomspace.get_handles_by_name_prefix(handle_vector, t, c_prefix, subtype)
+        return convert_handle_seq_to_python_list(handle_vector, self)
+
+    def get_atoms_by_name_range(self, Type t, lo, hi, subtype = False):
+        """ Return the nodes of type t whose names are in [lo, hi),
+        in name order """
+        if self.atomspace == NULL:
+            return None
+        cdef vector[cHandle] handle_vector
+        cdef string c_lo = lo.encode('UTF-8')
+        cdef string c_hi = hi.encode('UTF-8')
+        self.atomspace.get_handles_by_name_range(handle_vector, t, c_lo, c_hi, subtype)
+        return convert_handle_seq_to_python_list(handle_vector, self)
+
+    def get_atoms_by_name_substring(self, Type t, substring, subtype = False):
+        """ Return the nodes of type t whose names contain substring """
+        if self.atomspace == NULL:
+            return None
+        cdef vector[cHandle] handle_vector
+        cdef string c_str = substring.encode('UTF-8')
+        self.atomspace.get_handles_by_name_substring(handle_vector, t, c_str, subtype)
+        return convert_handle_seq_to_python_list(handle_vector, self)
+
+    def index_name_substrings(self, on = True):
+        """ Keep (or drop) a trigram index of node names, to speed up
+        get_atoms_by_name_substring """
+        if self.atomspace == NULL:
+            return None
+        self.atomspace.enable_name_substrings(on)
+
     def get_atoms_by_av(self, lower_bound, upper_bound=None):
         if self.atomspace == NULL:
             return None
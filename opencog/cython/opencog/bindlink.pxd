@@ -24,3 +24,15 @@ cdef extern from "opencog/query/BindLinkAPI.h" namespace "opencog":
 
 cdef extern from "opencog/atoms/execution/EvaluationLink.h" namespace "opencog":
     tv_ptr c_evaluate_atom "opencog::EvaluationLink::do_evaluate"(cAtomSpace*, cHandle)
+
+cdef extern from "opencog/query/GroundingCursor.h" namespace "opencog":
+    # C++:
+    #   GroundingCursor(AtomSpace*, Handle, size_t offset, size_t limit,
+    #                   bool add_results);
+    #   Handle next();
+    #
+    cdef cppclass cGroundingCursor "opencog::GroundingCursor":
+        cGroundingCursor(cAtomSpace*, cHandle, cSize, cSize, bint) except +
+        cHandle next() nogil except +
+        void close()
+        cSize count()
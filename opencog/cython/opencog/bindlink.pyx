@@ -74,6 +74,50 @@ def first_n_satisfying_set(AtomSpace atomspace, Atom atom, max_results):
     cdef Atom result = Atom(void_from_candle(c_result), atomspace)
     return result
 
+cdef class GroundingCursor:
+    """ Iterate over the results of a BindLink or a GetLink, as the
+    pattern matcher finds them, instead of collecting them all into a
+    SetLink. The first `offset` results are skipped, and the search
+    stops after `limit` results. Nothing is added to the atomspace
+    unless `add_results` is True.
+    """
+    cdef cGroundingCursor* c_cursor
+    cdef AtomSpace atomspace
+
+    def __cinit__(self, AtomSpace atomspace, Atom atom, offset=0,
+                  limit=None, add_results=False):
+        if atom == None: raise ValueError("GroundingCursor atom is: None")
+        cdef cSize c_limit = <cSize> -1
+        if limit is not None:
+            c_limit = limit
+        self.atomspace = atomspace
+        self.c_cursor = new cGroundingCursor(atomspace.atomspace,
+                                             deref(atom.handle),
+                                             offset, c_limit, add_results)
+
+    def __dealloc__(self):
+        del self.c_cursor
+
+    def __iter__(self):
+        return self
+
+    def __next__(self):
+        cdef cHandle c_result
+        # The search runs in a thread of its own, which may need the
+        # GIL to evaluate python predicates.
+        with nogil:
+            c_result = self.c_cursor.next()
+        if c_result.atom_ptr() == NULL:
+            raise StopIteration
+        return Atom(void_from_candle(c_result), self.atomspace)
+
+    def close(self):
+        self.c_cursor.close()
+
+    @property
+    def count(self):
+        return self.c_cursor.count()
+
 def execute_atom(AtomSpace atomspace, Atom atom):
     if atom == None: raise ValueError("execute_atom atom is: None")
     cdef cHandle c_result = c_execute_atom(atomspace.atomspace,
@@ -1,6 +1,6 @@
 from cython.operator cimport dereference as deref
 
-from atomspace cimport cTruthValue, tv_ptr
+from atomspace cimport cTruthValue, tv_ptr, create_simple_tv
 
 cdef class TruthValue:
     """ The truth value represents the strength and confidence of
@@ -15,8 +15,8 @@ cdef class TruthValue:
     # cdef tv_ptr *cobj
 
     def __cinit__(self, strength=1.0, confidence=0.0):
-        # By default create a SimpleTruthValue
-        self.cobj = new tv_ptr(new cSimpleTruthValue(strength, confidence))
+        # By default create a SimpleTruthValue (or a compact one)
+        self.cobj = new tv_ptr(create_simple_tv(strength, confidence))
 
     def __dealloc__(self):
         # This deletes the *smart pointer*, not the actual pointer
@@ -41,7 +41,7 @@ cdef class TruthValue:
         return self._ptr().getCount()
 
     cdef _init(self, float mean, float confidence):
-        self.cobj = new tv_ptr(new cSimpleTruthValue(mean, confidence))
+        self.cobj = new tv_ptr(create_simple_tv(mean, confidence))
 
     def __richcmp__(TruthValue h1, TruthValue h2, int op):
         " @todo support the rest of the comparison operators"
@@ -308,6 +308,8 @@ void SchemeSmob::register_procs()
 	register_proc("cog-arity",             1, 0, 0, C(ss_arity));
 	register_proc("cog-incoming-set",      1, 0, 0, C(ss_incoming_set));
 	register_proc("cog-incoming-by-type",  2, 0, 0, C(ss_incoming_by_type));
+	register_proc("cog-incoming-by-position", 3, 0, 0, C(ss_incoming_by_position));
+	register_proc("cog-index-positions!",  1, 0, 0, C(ss_index_positions));
 	register_proc("cog-outgoing-set",      1, 0, 0, C(ss_outgoing_set));
 	register_proc("cog-outgoing-by-type",  2, 0, 0, C(ss_outgoing_by_type));
 	register_proc("cog-outgoing-atom",     2, 0, 0, C(ss_outgoing_atom));
@@ -371,6 +373,12 @@ void SchemeSmob::register_procs()
 	// Iterators
 	register_proc("cog-map-type",          2, 0, 0, C(ss_map_type));
 
+	// Node-name lookups
+	register_proc("cog-nodes-by-prefix",   2, 0, 0, C(ss_nodes_by_prefix));
+	register_proc("cog-nodes-by-range",    3, 0, 0, C(ss_nodes_by_range));
+	register_proc("cog-nodes-by-substring", 2, 0, 0, C(ss_nodes_by_substring));
+	register_proc("cog-index-name-substrings!", 1, 0, 0, C(ss_index_name_substrings));
+
 	// Free variables
 	register_proc("cog-free-variables",    1, 0, 0, C(ss_get_free_variables));
 	register_proc("cog-closed?",           1, 0, 0, C(ss_is_closed));
@@ -43,6 +43,7 @@ class SchemeSmob
 	template<typename R, typename T, class... Args> friend class SchemePrimitiveBase;
 
 	friend class LoggerSCM;
+	friend class PatternSCM;
 
 private:
 
@@ -72,6 +73,7 @@ private:
 	static size_t free_misc(SCM);
 
 	static SCM handle_to_scm(const Handle&);
+	static SCM handle_seq_to_scm(const HandleSeq&);
 	static SCM protom_to_scm(const ProtoAtomPtr&);
 	static SCM tv_to_scm(const TruthValuePtr&);
 	static Handle scm_to_handle(SCM);
@@ -124,12 +126,18 @@ private:
 	static SCM ss_value(SCM, SCM);
 	static SCM ss_incoming_set(SCM);
 	static SCM ss_incoming_by_type(SCM, SCM);
+	static SCM ss_incoming_by_position(SCM, SCM, SCM);
+	static SCM ss_index_positions(SCM);
 	static SCM ss_outgoing_set(SCM);
 	static SCM ss_outgoing_by_type(SCM, SCM);
 	static SCM ss_outgoing_atom(SCM, SCM);
 
 	// Type query functions
 	static SCM ss_map_type(SCM, SCM);
+	static SCM ss_nodes_by_prefix(SCM, SCM);
+	static SCM ss_nodes_by_range(SCM, SCM, SCM);
+	static SCM ss_nodes_by_substring(SCM, SCM);
+	static SCM ss_index_name_substrings(SCM);
 	static SCM ss_get_types(void);
 	static SCM ss_get_type(SCM);
 	static SCM ss_type_p(SCM);
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include <cstddef>
+#include <limits>
 #include <libguile.h>
 
 #include <opencog/atoms/base/ClassServer.h>
@@ -284,6 +285,36 @@ SCM SchemeSmob::ss_incoming_by_type (SCM satom, SCM stype)
 
 /* ============================================================== */
 
+/**
+ * Return the links of type stype that hold satom at position spos
+ * of their outgoing set.
+ */
+SCM SchemeSmob::ss_incoming_by_position (SCM satom, SCM stype, SCM spos)
+{
+	Handle h = verify_handle(satom, "cog-incoming-by-position");
+	Type t = verify_atom_type(stype, "cog-incoming-by-position", 2);
+	size_t pos = verify_size(spos, "cog-incoming-by-position", 3);
+	AtomSpace* atomspace = ss_get_env_as("cog-incoming-by-position");
+
+	SCM head = SCM_EOL;
+	if (std::numeric_limits<Arity>::max() < pos) return head;
+	for (const LinkPtr& l : atomspace->get_incoming_by_position(h, t, pos))
+		head = scm_cons(handle_to_scm(Handle(l)), head);
+	return head;
+}
+
+/**
+ * Turn the index of incoming links by position on or off.
+ */
+SCM SchemeSmob::ss_index_positions (SCM son)
+{
+	AtomSpace* atomspace = ss_get_env_as("cog-index-positions!");
+	atomspace->enable_position_index(scm_is_true(son));
+	return SCM_UNSPECIFIED;
+}
+
+/* ============================================================== */
+
 /**
  * Apply proceedure proc to all atoms of type stype
  * If the proceedure returns something other than #f,
@@ -314,6 +345,74 @@ SCM SchemeSmob::ss_map_type (SCM proc, SCM stype)
 
 /* ============================================================== */
 
+/**
+ * Return a scheme list of the atoms, in the same order.
+ */
+SCM SchemeSmob::handle_seq_to_scm (const HandleSeq& hs)
+{
+	SCM head = SCM_EOL;
+	for (auto it = hs.rbegin(); it != hs.rend(); it++)
+		head = scm_cons(handle_to_scm(*it), head);
+	return head;
+}
+
+/**
+ * Return a list of the nodes of type stype whose names start with
+ * sprefix, in name order.
+ */
+SCM SchemeSmob::ss_nodes_by_prefix (SCM stype, SCM sprefix)
+{
+	Type t = verify_atom_type(stype, "cog-nodes-by-prefix", 1);
+	std::string prefix(verify_string(sprefix, "cog-nodes-by-prefix", 2));
+	AtomSpace* atomspace = ss_get_env_as("cog-nodes-by-prefix");
+
+	HandleSeq hs;
+	atomspace->get_handles_by_name_prefix(hs, t, prefix);
+	return handle_seq_to_scm(hs);
+}
+
+/**
+ * Return a list of the nodes of type stype whose names lie in the
+ * half-open range [slo, shi), in name order.
+ */
+SCM SchemeSmob::ss_nodes_by_range (SCM stype, SCM slo, SCM shi)
+{
+	Type t = verify_atom_type(stype, "cog-nodes-by-range", 1);
+	std::string lo(verify_string(slo, "cog-nodes-by-range", 2));
+	std::string hi(verify_string(shi, "cog-nodes-by-range", 3));
+	AtomSpace* atomspace = ss_get_env_as("cog-nodes-by-range");
+
+	HandleSeq hs;
+	atomspace->get_handles_by_name_range(hs, t, lo, hi);
+	return handle_seq_to_scm(hs);
+}
+
+/**
+ * Return a list of the nodes of type stype whose names contain sstr.
+ */
+SCM SchemeSmob::ss_nodes_by_substring (SCM stype, SCM sstr)
+{
+	Type t = verify_atom_type(stype, "cog-nodes-by-substring", 1);
+	std::string str(verify_string(sstr, "cog-nodes-by-substring", 2));
+	AtomSpace* atomspace = ss_get_env_as("cog-nodes-by-substring");
+
+	HandleSeq hs;
+	atomspace->get_handles_by_name_substring(hs, t, str);
+	return handle_seq_to_scm(hs);
+}
+
+/**
+ * Turn the trigram index of node names on or off.
+ */
+SCM SchemeSmob::ss_index_name_substrings (SCM son)
+{
+	AtomSpace* atomspace = ss_get_env_as("cog-index-name-substrings!");
+	atomspace->enable_name_substrings(scm_is_true(son));
+	return SCM_UNSPECIFIED;
+}
+
+/* ============================================================== */
+
 /**
  * Return a list of all of the atom types in the system.
  */
@@ -133,7 +133,7 @@ std::string SchemeSmob::tv_to_string(const TruthValuePtr& tv)
 
 	// Pretend they're floats, not doubles, so print with 8 digits
 	std::string ret = "";
-	if (SIMPLE_TRUTH_VALUE == tvt)
+	if (SIMPLE_TRUTH_VALUE == tvt or COMPACT_TRUTH_VALUE == tvt)
 	{
 		snprintf(buff, BUFLEN, "(stv %.8g ", tv->getMean());
 		ret += buff;
@@ -296,6 +296,8 @@ inline SCM SchemeSmob::tv_p (SCM s, Type wanted)
 
 SCM SchemeSmob::ss_stv_p (SCM s)
 {
+	// The single-precision CompactTruthValue is an stv, too.
+	if (scm_is_true(tv_p(s, COMPACT_TRUTH_VALUE))) return SCM_BOOL_T;
 	return tv_p(s, SIMPLE_TRUTH_VALUE);
 }
 
@@ -353,7 +355,7 @@ SCM SchemeSmob::ss_tv_get_value (SCM s)
 	TruthValuePtr tv = verify_tv(s, "cog-tv->alist");
 	Type tvt = tv->getType();
 
-	if (SIMPLE_TRUTH_VALUE == tvt)
+	if (SIMPLE_TRUTH_VALUE == tvt or COMPACT_TRUTH_VALUE == tvt)
 	{
 		SCM mean = scm_from_double(tv->getMean());
 		SCM conf = scm_from_double(tv->getConfidence());
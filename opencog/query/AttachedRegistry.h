@@ -0,0 +1,95 @@
+/*
+ * AttachedRegistry.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_ATTACHED_REGISTRY_H
+#define _OPENCOG_ATTACHED_REGISTRY_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <opencog/atoms/base/Handle.h>
+#include <opencog/atomspace/AtomSpace.h>
+
+namespace opencog {
+
+/**
+ * class AttachedRegistry -- at most one T per atomspace, by atomspace
+ * UUID; used for the indexes and statistics that are attached to an
+ * atomspace, such as the NumberIndex and the TypeStats.
+ *
+ * A T is built from the atomspace by attach(), the first time it is
+ * asked for, and lives until its atomspace is deleted; T::alive()
+ * tells when that has happened. The Ts of deleted atomspaces are
+ * dropped the next time a T is built, so that they don't hold on to
+ * atoms for long.
+ *
+ * Looking up a T with attached() takes no lock, as every query does
+ * it. The map is never changed in place: attach() makes a new one,
+ * under a lock, and swaps it in. A lookup thus sees either the old
+ * map or the new one.
+ */
+template<class T>
+class AttachedRegistry
+{
+	private:
+		typedef std::map<UUID, std::shared_ptr<T>> Map;
+
+		std::mutex _mtx;
+		std::shared_ptr<const Map> _map;
+
+	public:
+		AttachedRegistry(void) : _map(std::make_shared<const Map>()) {}
+
+		/// The T attached to the atomspace, building it if there is
+		/// none yet.
+		T* attach(AtomSpace* as)
+		{
+			std::lock_guard<std::mutex> lck(_mtx);
+			std::shared_ptr<const Map> cur(std::atomic_load(&_map));
+			auto it = cur->find(as->get_uuid());
+			if (cur->end() != it) return it->second.get();
+
+			std::shared_ptr<Map> next(std::make_shared<Map>());
+			for (const auto& pr : *cur)
+				if (pr.second->alive()) next->insert(pr);
+
+			std::shared_ptr<T> t(std::make_shared<T>(as));
+			next->emplace(as->get_uuid(), t);
+			std::atomic_store(&_map, std::shared_ptr<const Map>(next));
+			return t.get();
+		}
+
+		/// The T attached to the atomspace, or null if none.
+		T* attached(AtomSpace* as) const
+		{
+			if (nullptr == as) return nullptr;
+			std::shared_ptr<const Map> cur(std::atomic_load(&_map));
+			auto it = cur->find(as->get_uuid());
+			if (cur->end() == it) return nullptr;
+			return it->second.get();
+		}
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_ATTACHED_REGISTRY_H
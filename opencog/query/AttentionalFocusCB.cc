@@ -21,41 +21,80 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+
 #include "AttentionalFocusCB.h"
-#include <opencog/attentionbank/AttentionBank.h>
 
 using namespace opencog;
 
 AttentionalFocusCB::AttentionalFocusCB(AtomSpace* as) :
 	DefaultPatternMatchCB(as)
 {
+	_af_members = attentionbank(_as).get_af_members();
+}
+
+void AttentionalFocusCB::set_pattern(const Variables& vars,
+                                     const Pattern& pat)
+{
+	_af_members = attentionbank(_as).get_af_members();
+	DefaultPatternMatchCB::set_pattern(vars, pat);
 }
 
 bool AttentionalFocusCB::node_match(const Handle& node1, const Handle& node2)
 {
-	return attentionbank(_as).atom_is_in_AF(node2) and node1 == node2;
+	return in_af(node2) and node1 == node2;
 }
 
 bool AttentionalFocusCB::link_match(const PatternTermPtr& ptm, const Handle& lsoln)
 {
-	return attentionbank(_as).atom_is_in_AF(lsoln) and 
-           DefaultPatternMatchCB::link_match(ptm, lsoln);
+	return in_af(lsoln) and DefaultPatternMatchCB::link_match(ptm, lsoln);
 }
 
+/// Sort, highest STI first. The STI of each atom is looked up only
+/// once, as each lookup takes a lock in the attention bank.
+template<typename T>
+static void sort_by_sti(AtomSpace* as, std::vector<T>& seq)
+{
+	AttentionBank& ab = attentionbank(as);
+	std::vector<std::pair<AttentionValue::sti_t, T>> keyed;
+	keyed.reserve(seq.size());
+	for (const T& a : seq)
+		keyed.push_back({ab.get_sti(Handle(a)), a});
+
+	std::stable_sort(keyed.begin(), keyed.end(),
+		[](const std::pair<AttentionValue::sti_t, T>& a,
+		   const std::pair<AttentionValue::sti_t, T>& b)
+		{ return a.first > b.first; });
+
+	for (size_t i = 0; i < seq.size(); i++)
+		seq[i] = keyed[i].second;
+}
 
 IncomingSet AttentionalFocusCB::get_incoming_set(const Handle& h)
 {
-	const IncomingSet &incoming_set = h->getIncomingSet();
-
 	// Discard the part of the incoming set that is below the
 	// AF boundary.  The PM will look only at those links that
 	// this callback returns; thus we avoid searching the low-AF
-	// parts of the hypergraph.
-    IncomingSet filtered_set;
-    for (const auto& l : incoming_set){
-        if(attentionbank(_as).atom_is_in_AF(Handle(l)))
-            filtered_set.push_back(l);
-    }
+	// parts of the hypergraph.  If the incoming set is bigger than
+	// the AF, it is cheaper to look for the links that contain h
+	// among the AF members.
+	IncomingSet filtered_set;
+	if (_af_members->size() < h->getIncomingSetSize())
+	{
+		for (const Handle& af : *_af_members)
+		{
+			if (not af->isLink()) continue;
+			const HandleSeq& oset = af->getOutgoingSet();
+			if (oset.end() != std::find(oset.begin(), oset.end(), h))
+				filtered_set.push_back(LinkCast(af));
+		}
+	}
+	else
+	{
+		for (const LinkPtr& l : h->getIncomingSet())
+			if (in_af(Handle(l)))
+				filtered_set.push_back(l);
+	}
 
 	// If nothing is in AF
 	if (filtered_set.empty())
@@ -66,16 +105,40 @@ IncomingSet AttentionalFocusCB::get_incoming_set(const Handle& h)
 		return filtered_set;
 	}
 
-	auto compare_sti = [&](const LinkPtr& lptr1, const LinkPtr& lptr2)->bool
-	{
-		return attentionbank(_as).get_sti(Handle(lptr1)) >
-			attentionbank(_as).get_sti(Handle(lptr2));
-	};
-
 	// The exploration of the set of patterns proceeds by going through
 	// the incoming set, one by one.  So sorting the incoming set will
 	// cause the exploration to look at the highest STI atoms first.
-	std::sort(filtered_set.begin(), filtered_set.end(), compare_sti);
+	sort_by_sti(_as, filtered_set);
+
+	return filtered_set;
+}
+
+/// As above, but only for the links of the given type that hold `h`
+/// at the given position.  That slice is usually small, so it is
+/// taken from the atomspace (and its position index, if on), and
+/// simply filtered.
+IncomingSet AttentionalFocusCB::get_incoming_by_position(const Handle& h,
+                                                         Type t, Arity pos)
+{
+	IncomingSet filtered_set;
+	for (const LinkPtr& l : _as->get_incoming_by_position(h, t, pos))
+		if (in_af(Handle(l)))
+			filtered_set.push_back(l);
 
+	sort_by_sti(_as, filtered_set);
 	return filtered_set;
 }
+
+void AttentionalFocusCB::get_af_candidates(HandleSeq& handle_set, Type t,
+                                           bool subclass)
+{
+	HandleSeq found;
+	for (const Handle& h : *_af_members)
+	{
+		Type ht = h->getType();
+		if (ht == t or (subclass and classserver().isA(ht, t)))
+			found.push_back(h);
+	}
+	sort_by_sti(_as, found);
+	handle_set.insert(handle_set.end(), found.begin(), found.end());
+}
@@ -23,15 +23,25 @@
 #ifndef _ATTENTIONAL_FOCUS_CB_H
 #define _ATTENTIONAL_FOCUS_CB_H
 
+#include <opencog/attentionbank/AttentionBank.h>
 #include "DefaultPatternMatchCB.h"
 
 namespace opencog {
 
+/**
+ * Restricts the search to the atoms in the attentional focus. The
+ * members of the AF are fetched when the pattern is set, and that
+ * view of the AF is used for the whole search; membership tests on it
+ * take no lock.
+ */
 class AttentionalFocusCB: public virtual DefaultPatternMatchCB
 {
 public:
 	AttentionalFocusCB(AtomSpace*);
 
+	// Takes a fresh view of the attentional focus.
+	virtual void set_pattern(const Variables&, const Pattern&);
+
 	// Only match nodes if they are in the attentional focus
 	bool node_match(const Handle&, const Handle&);
 
@@ -40,6 +50,20 @@ public:
 
 	// Only get incoming sets that are in the attentional focus
 	IncomingSet get_incoming_set(const Handle&);
+	IncomingSet get_incoming_by_position(const Handle&, Type, Arity);
+
+protected:
+	AFMembersPtr _af_members;
+
+	bool in_af(const Handle& h) const
+	{
+		return 0 < _af_members->count(h);
+	}
+
+	// The atoms of the given type in the attentional focus, highest
+	// STI first. Searches that start from these, rather than from all
+	// the atoms of the type, cost in proportion to the size of the AF.
+	void get_af_candidates(HandleSeq&, Type, bool subclass);
 };
 
 } //namespace opencog
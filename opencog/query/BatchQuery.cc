@@ -0,0 +1,405 @@
+/*
+ * BatchQuery.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
+
+#include <opencog/util/Logger.h>
+#include <opencog/atomutils/FindUtils.h>
+#include <opencog/atoms/base/ClassServer.h>
+#include <opencog/atoms/base/Node.h>
+#include <opencog/atoms/pattern/BindLink.h>
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "BindLinkAPI.h"
+#include "DefaultImplicator.h"
+#include "QueryBudget.h"
+#include "Satisfier.h"
+
+using namespace opencog;
+
+/**
+ * Batch execution of queries.
+ *
+ * Rule bases are full of rules whose premises have a clause in
+ * common, up to the names of the variables; e.g. many rules start
+ * with (InheritanceLink $A $B). Run one at a time, each of these
+ * rules searches for the groundings of that clause all over again.
+ * Here, the queries of a batch are grouped by such a shared clause;
+ * the clause is grounded once for the whole group, and each query in
+ * the group is then started at the shared clause, with only those
+ * groundings as candidates (see PatternLink::satisfy_from()). Each
+ * query applies its own callbacks to the rest of its pattern.
+ *
+ * The queries are still run one by one, in the order given, and each
+ * one sees what the earlier ones added to the atomspace. A BindLink
+ * whose implicand could add (or remove) atoms of the type of a shared
+ * clause makes the groundings of that clause stale; they are found
+ * again before the next query that uses them. Thus, the results are
+ * those of running the queries one at a time; the sharing only pays
+ * off for the groups whose clause is not touched by the queries that
+ * run in between.
+ *
+ * Only the anchoring clause is shared; it is the one that costs the
+ * most, as it is grounded from scratch, while the rest of each
+ * pattern is explored from the neighborhood of its grounding.
+ */
+
+/* ======================================================== */
+
+/// Collects the distinct groundings of a single clause.
+class ClauseGroundings :
+	public virtual InitiateSearchCB,
+	public virtual DefaultPatternMatchCB
+{
+	public:
+		ClauseGroundings(AtomSpace* as, const Handle& clause) :
+			InitiateSearchCB(as), DefaultPatternMatchCB(as),
+			_clause(clause)
+		{ use_position_index(); }
+
+		HandleSeq groundings;
+
+		virtual void set_pattern(const Variables& vars,
+		                         const Pattern& pat)
+		{
+			InitiateSearchCB::set_pattern(vars, pat);
+			DefaultPatternMatchCB::set_pattern(vars, pat);
+		}
+
+		// The clause stands in for the clauses of the other queries,
+		// which do not use its variables; so it may ground to itself.
+		// Each query checks its own clause again, anyway.
+		virtual bool clause_match(const Handle&, const Handle&,
+		                          const HandleMap&)
+		{
+			return true;
+		}
+
+		virtual bool grounding(const HandleMap&,
+		                       const HandleMap& term_soln)
+		{
+			auto gnd = term_soln.find(_clause);
+			if (term_soln.end() != gnd and _seen.insert(gnd->second).second)
+				groundings.push_back(gnd->second);
+			return false;
+		}
+
+	private:
+		Handle _clause;
+		UnorderedHandleSet _seen;
+};
+
+/* ======================================================== */
+
+/// Print the clause with its variables renamed in order of first
+/// appearance, and tagged with their type restrictions. Two clauses
+/// get the same key only if they are the same up to alpha-conversion.
+/// Returns false if the clause cannot be shared: if it has variables
+/// with restrictions other than simple types, or scoped or quoted
+/// parts, whose variables the renaming would get wrong.
+static bool clause_key(const Handle& h, const Variables& vars,
+                       std::map<Handle, size_t>& names, std::string& key)
+{
+	ClassServer& cs = classserver();
+	Type t = h->getType();
+
+	if (vars.is_in_varset(h))
+	{
+		if (vars._deep_typemap.count(h) or vars._fuzzy_typemap.count(h)
+		    or vars._glob_intervalmap.count(h))
+			return false;
+
+		auto nm = names.find(h);
+		if (names.end() == nm)
+			nm = names.insert({h, names.size()}).first;
+		key += "$" + std::to_string(nm->second);
+
+		auto tm = vars._simple_typemap.find(h);
+		if (vars._simple_typemap.end() != tm)
+		{
+			key += "{";
+			for (Type vt : tm->second)
+				key += cs.getTypeName(vt) + " ";
+			key += "}";
+		}
+		return true;
+	}
+
+	if (h->isNode())
+	{
+		key += cs.getTypeName(t) + "\"" + h->getName() + "\"";
+		return true;
+	}
+
+	if (cs.isA(t, SCOPE_LINK) or QUOTE_LINK == t or UNQUOTE_LINK == t
+	    or LOCAL_QUOTE_LINK == t)
+		return false;
+
+	key += "(" + cs.getTypeName(t);
+	for (const Handle& ho : h->getOutgoingSet())
+	{
+		key += " ";
+		if (not clause_key(ho, vars, names, key)) return false;
+	}
+	key += ")";
+	return true;
+}
+
+static PatternLinkPtr to_pattern(const Handle& query)
+{
+	PatternLinkPtr pl(PatternLinkCast(query));
+	if (pl) return pl;
+	if (BIND_LINK == query->getType())
+		return createBindLink(*LinkCast(query));
+	return createPatternLink(*LinkCast(query));
+}
+
+/// Can this query be started at a shared clause? It must be a single
+/// component, and must not need any analysis at search time.
+static bool can_share(const PatternLinkPtr& pl)
+{
+	const Pattern& pat = pl->get_pattern();
+	return pl->get_num_comps() <= 1 and pat.defined_terms.empty()
+		and not pat.mandatory.empty();
+}
+
+/// Run a query that shares no clause with the others.
+static Handle run_alone(AtomSpace* as, const Handle& query,
+                        size_t max_results, const QueryBudget* limits)
+{
+	if (nullptr == limits)
+		return satisfying_set(as, query, max_results);
+
+	QueryBudget budget(*limits);
+	return budgeted_query(as, query, budget, max_results);
+}
+
+/// Run a query, starting at its clause `clause`, with the groundings
+/// of the shared clause as the only candidates.
+static Handle run_shared(AtomSpace* as, const PatternLinkPtr& pl,
+                         const Handle& clause, const HandleSeq& gnds,
+                         size_t max_results, const QueryBudget* limits)
+{
+	QueryBudget budget;
+	if (limits) budget = *limits;
+	budget.reset();
+
+	BindLinkPtr bl(BindLinkCast(pl));
+	if (bl)
+	{
+		DefaultImplicator impl(as);
+		impl.implicand = bl->get_implicand();
+		impl.max_results = max_results;
+		if (limits) impl.budget = &budget;
+		bl->satisfy_from(impl, clause, gnds);
+		return as->add_link(SET_LINK, impl.get_result_list());
+	}
+
+	SatisfyingSet sater(as);
+	sater.max_results = max_results;
+	if (limits) sater.budget = &budget;
+	pl->satisfy_from(sater, clause, gnds);
+
+	HandleSeq satvec(sater._satisfying_set.begin(),
+	                 sater._satisfying_set.end());
+	return as->add_link(SET_LINK, satvec);
+}
+
+/// A clause that several queries of a batch have in common, and its
+/// groundings, if they are still good.
+struct SharedClause
+{
+	Handle clause;
+	Variables vars;
+	HandleSeq groundings;
+	bool grounded = false;
+};
+
+/// Find the groundings of the shared clause.
+static void ground_shared(AtomSpace* as, SharedClause& sc,
+                          const QueryBudget* limits)
+{
+	Variables cvars(sc.vars);
+	for (const Handle& v : sc.vars.varseq)
+		if (not is_unquoted_in_tree(sc.clause, v))
+			cvars.erase(v);
+
+	PatternLinkPtr cpl(createPatternLink(cvars, sc.clause));
+	ClauseGroundings cgnds(as, sc.clause);
+	// Only the clock applies here: cutting the shared groundings
+	// short would leave every query in the group with partial
+	// candidates, rather than just the one that ran out.
+	QueryBudget cbudget;
+	if (limits and 0.0 < limits->max_seconds)
+	{
+		cbudget.max_seconds = limits->max_seconds;
+		cgnds.budget = &cbudget;
+	}
+	cpl->satisfy(cgnds);
+
+	LAZY_LOG_FINE << "Batch: shared clause has "
+	              << cgnds.groundings.size() << " groundings:\n"
+	              << sc.clause->toShortString();
+
+	sc.groundings.swap(cgnds.groundings);
+	sc.grounded = true;
+}
+
+/// Could running the query add, or remove, atoms of type `ct`? Every
+/// query adds a SetLink of its results. A BindLink also adds its
+/// implicand, with the variables filled in; that makes only atoms of
+/// the link types written in it, unless it runs something (a function,
+/// schema, nested query or deletion), which could make anything.
+static bool may_touch(const PatternLinkPtr& pl, Type ct)
+{
+	if (SET_LINK == ct) return true;
+	BindLinkPtr bl(BindLinkCast(pl));
+	if (nullptr == bl) return false;
+
+	ClassServer& cs = classserver();
+	std::function<bool(const Handle&)> touches = [&](const Handle& h)
+	{
+		Type t = h->getType();
+		if (h->isNode()) return DEFINED_SCHEMA_NODE == t;
+		if (ct == t or DELETE_LINK == t or PUT_LINK == t or
+		    cs.isA(t, FUNCTION_LINK) or cs.isA(t, SATISFYING_LINK))
+			return true;
+		for (const Handle& ho : h->getOutgoingSet())
+			if (touches(ho)) return true;
+		return false;
+	};
+	return touches(bl->get_implicand());
+}
+
+/**
+ * Run a batch of BindLinks and GetLinks, grounding the clauses they
+ * have in common only once. Returns a SetLink of results for each
+ * query, in the same order as the queries. If `limits` is given, each
+ * query gets a budget with those limits. If `on_result` is given, it
+ * is called with the index and the results of each query, as soon as
+ * that query is done, and before the next one runs.
+ */
+HandleSeq opencog::batch_query(AtomSpace* as, const HandleSeq& queries,
+                               size_t max_results,
+                               const QueryBudget* limits,
+                               const BatchResultCB& on_result)
+{
+	size_t nq = queries.size();
+	HandleSeq results(nq);
+
+	// The shareable clauses of each query, by key. A query is listed
+	// at most once under any key.
+	std::vector<PatternLinkPtr> pls(nq);
+	std::map<std::string, std::vector<std::pair<size_t, Handle>>> by_key;
+	for (size_t qi = 0; qi < nq; qi++)
+	{
+		Type qt = queries[qi]->getType();
+		if (BIND_LINK != qt and GET_LINK != qt) continue;
+
+		pls[qi] = to_pattern(queries[qi]);
+		if (not can_share(pls[qi])) continue;
+
+		const Pattern& pat = pls[qi]->get_pattern();
+		const Variables& vars = pls[qi]->get_variables();
+		std::set<std::string> keys;
+		for (const Handle& clause : pat.mandatory)
+		{
+			if (not clause->isLink() or pat.evaluatable_holders.count(clause)
+			    or pat.black.count(clause))
+				continue;
+
+			std::map<Handle, size_t> names;
+			std::string key;
+			if (not clause_key(clause, vars, names, key)) continue;
+			if (names.empty() or not keys.insert(key).second) continue;
+			by_key[key].push_back({qi, clause});
+		}
+	}
+
+	// Greedily pick the clause shared by the most queries, until
+	// no clause is shared by two or more of the remaining ones.
+	std::vector<SharedClause> shared;
+	std::vector<size_t> group(nq, SIZE_MAX);
+	HandleSeq own_clause(nq);
+	while (true)
+	{
+		const std::vector<std::pair<size_t, Handle>>* best = nullptr;
+		size_t best_size = 1;
+		for (const auto& kv : by_key)
+		{
+			size_t sz = 0;
+			for (const auto& qc : kv.second)
+				if (SIZE_MAX == group[qc.first]) sz++;
+			if (best_size < sz)
+			{
+				best_size = sz;
+				best = &kv.second;
+			}
+		}
+		if (nullptr == best) break;
+
+		// The shared clause is grounded with the variables of the
+		// first query that has it.
+		SharedClause sc;
+		for (const auto& qc : *best)
+		{
+			if (SIZE_MAX != group[qc.first]) continue;
+			if (nullptr == sc.clause)
+			{
+				sc.clause = qc.second;
+				sc.vars = pls[qc.first]->get_variables();
+			}
+			group[qc.first] = shared.size();
+			own_clause[qc.first] = qc.second;
+		}
+		shared.push_back(sc);
+	}
+
+	for (size_t qi = 0; qi < nq; qi++)
+	{
+		size_t gi = group[qi];
+		if (SIZE_MAX == gi)
+			results[qi] = run_alone(as, queries[qi], max_results, limits);
+		else
+		{
+			SharedClause& sc = shared[gi];
+			if (not sc.grounded) ground_shared(as, sc, limits);
+			results[qi] = run_shared(as, pls[qi], own_clause[qi],
+			                         sc.groundings, max_results, limits);
+		}
+
+		// Whatever this query added may ground the shared clauses
+		// that are still to be used.
+		for (SharedClause& sc : shared)
+			if (sc.grounded and may_touch(pls[qi], sc.clause->getType()))
+				sc.grounded = false;
+
+		if (on_result) on_result(qi, results[qi]);
+	}
+
+	return results;
+}
+
+/* ===================== END OF FILE ===================== */
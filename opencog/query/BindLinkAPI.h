@@ -22,12 +22,18 @@
 #ifndef _OPENCOG_BINDLINK_API_H
 #define _OPENCOG_BINDLINK_API_H
 
+#include <functional>
+
 #include <opencog/atoms/base/Handle.h>
 #include <opencog/truthvalue/TruthValue.h>
 
 namespace opencog {
 
 class AtomSpace;
+struct PatternProfile;
+struct QueryBudget;
+class RecognizerIndex;
+struct SearchPlan;
 
 Handle bindlink(AtomSpace*, const Handle&, size_t max_results=SIZE_MAX);
 Handle af_bindlink(AtomSpace*, const Handle&);
@@ -35,6 +41,35 @@ TruthValuePtr satisfaction_link(AtomSpace*, const Handle&);
 Handle satisfying_set(AtomSpace*, const Handle&, size_t max_results=SIZE_MAX);
 Handle recognize(AtomSpace*, const Handle&);
 
+// Recognize, taking the candidate patterns from the index, instead of
+// searching the atomspace for them.
+Handle recognize(AtomSpace*, const Handle&, RecognizerIndex&);
+
+// Run a BindLink as bindlink() does, or any other PatternLink as
+// satisfying_set() does, collecting search statistics into `prof`.
+Handle profile_query(AtomSpace*, const Handle&, PatternProfile& prof,
+                     size_t max_results=SIZE_MAX);
+
+// Run the query as profile_query() does, but stop when any limit in
+// the budget is used up, returning what was found so far. The reason
+// for stopping is left in the budget's status.
+Handle budgeted_query(AtomSpace*, const Handle&, QueryBudget&,
+                      size_t max_results=SIZE_MAX);
+
+// Run several queries together; clauses that they have in common are
+// grounded only once. The queries still run in order, each one seeing
+// what the earlier ones added. Returns one SetLink of results per
+// query, in order. If `limits` is given, each query gets a budget with
+// those limits; `on_result`, if given, is called after each query.
+typedef std::function<void(size_t, const Handle&)> BatchResultCB;
+HandleSeq batch_query(AtomSpace*, const HandleSeq&,
+                      size_t max_results=SIZE_MAX,
+                      const QueryBudget* limits=nullptr,
+                      const BatchResultCB& on_result=nullptr);
+
+// Describe how the query would be searched, without running it.
+SearchPlan explain_query(AtomSpace*, const Handle&);
+
 } // namespace opencog
 
 #endif // _OPENCOG_BINDLINK_API_H
@@ -0,0 +1,186 @@
+/*
+ * CompiledTerm.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/atoms/base/ClassServer.h>
+#include <opencog/atoms/NumberNode.h>
+
+#include "CompiledTerm.h"
+
+using namespace opencog;
+
+/// The grounding of a variable, if it is a plain node; a link might
+/// have to be executed, and a NumberNode stands for itself only if it
+/// is one.
+static bool plain_grounding(const HandleMap& gnds, const Handle& var,
+                            Handle& gnd)
+{
+	auto it = gnds.find(var);
+	if (gnds.end() == it) return false;
+	Type t = it->second->getType();
+	if (not it->second->isNode() or VARIABLE_NODE == t or
+	    GLOB_NODE == t or DEFINED_SCHEMA_NODE == t)
+		return false;
+	gnd = it->second;
+	return true;
+}
+
+bool CompiledTerm::compile_number(const Handle& h, const HandleSet& varset,
+                                  NumberFn& fn)
+{
+	Type t = h->getType();
+	if (NUMBER_NODE == t)
+	{
+		NumberNodePtr nn(NumberNodeCast(h));
+		if (nullptr == nn) return false;
+		double value = nn->get_value();
+		fn = [value](const HandleMap&, double& v) { v = value; return true; };
+		return true;
+	}
+
+	if (VARIABLE_NODE == t)
+	{
+		if (0 == varset.count(h)) return false;
+		fn = [h](const HandleMap& gnds, double& v)
+		{
+			Handle gnd;
+			if (not plain_grounding(gnds, h, gnd)) return false;
+			NumberNodePtr nn(NumberNodeCast(gnd));
+			if (nullptr == nn) return false;
+			v = nn->get_value();
+			return true;
+		};
+		return true;
+	}
+
+	if (PLUS_LINK != t and MINUS_LINK != t and
+	    TIMES_LINK != t and DIVIDE_LINK != t)
+		return false;
+
+	const HandleSeq& oset = h->getOutgoingSet();
+	if ((MINUS_LINK == t or DIVIDE_LINK == t) and
+	    (0 == oset.size() or 2 < oset.size()))
+		return false;
+
+	std::vector<NumberFn> args(oset.size());
+	for (size_t i = 0; i < oset.size(); i++)
+		if (not compile_number(oset[i], varset, args[i])) return false;
+
+	// Same order of operations as ArithmeticLink::do_execute(), and
+	// the MinusLink and DivideLink overloads of it.
+	if (MINUS_LINK == t or DIVIDE_LINK == t)
+	{
+		bool minus = (MINUS_LINK == t);
+		fn = [args, minus](const HandleMap& gnds, double& v)
+		{
+			double a, b;
+			if (not args[0](gnds, a)) return false;
+			if (1 == args.size())
+			{
+				v = minus ? - a : 1.0 / a;
+				return true;
+			}
+			if (not args[1](gnds, b)) return false;
+			v = minus ? a - b : a / b;
+			return true;
+		};
+		return true;
+	}
+
+	bool plus = (PLUS_LINK == t);
+	fn = [args, plus](const HandleMap& gnds, double& v)
+	{
+		double acc = plus ? 0.0 : 1.0;
+		for (const NumberFn& arg : args)
+		{
+			double a;
+			if (not arg(gnds, a)) return false;
+			acc = plus ? acc + a : acc * a;
+		}
+		v = acc;
+		return true;
+	};
+	return true;
+}
+
+bool CompiledTerm::compile_atom(const Handle& h, const HandleSet& varset,
+                                AtomFn& fn)
+{
+	Type t = h->getType();
+	if (VARIABLE_NODE == t)
+	{
+		if (0 == varset.count(h)) return false;
+		fn = [h](const HandleMap& gnds, Handle& gnd)
+		{
+			return plain_grounding(gnds, h, gnd);
+		};
+		return true;
+	}
+
+	if (not h->isNode() or GLOB_NODE == t or DEFINED_SCHEMA_NODE == t)
+		return false;
+
+	fn = [h](const HandleMap&, Handle& gnd) { gnd = h; return true; };
+	return true;
+}
+
+bool CompiledTerm::compile(const Handle& term, const HandleSet& varset)
+{
+	Type t = term->getType();
+	if (GREATER_THAN_LINK != t and EQUAL_LINK != t and IDENTICAL_LINK != t)
+		return false;
+
+	const HandleSeq& oset = term->getOutgoingSet();
+	if (2 != oset.size()) return false;
+
+	if (GREATER_THAN_LINK == t)
+	{
+		NumberFn a, b;
+		if (not compile_number(oset[0], varset, a) or
+		    not compile_number(oset[1], varset, b))
+			return false;
+
+		_eval = [a, b](const HandleMap& gnds)
+		{
+			double va, vb;
+			if (not a(gnds, va) or not b(gnds, vb)) return UNKNOWN;
+			return va > vb ? TRUE_RESULT : FALSE_RESULT;
+		};
+		return true;
+	}
+
+	// With plain nodes as arguments, EqualLink and IdenticalLink
+	// are the same: nothing is executed.
+	AtomFn a, b;
+	if (not compile_atom(oset[0], varset, a) or
+	    not compile_atom(oset[1], varset, b))
+		return false;
+
+	_eval = [a, b](const HandleMap& gnds)
+	{
+		Handle ga, gb;
+		if (not a(gnds, ga) or not b(gnds, gb)) return UNKNOWN;
+		return ga == gb ? TRUE_RESULT : FALSE_RESULT;
+	};
+	return true;
+}
+
+/* ===================== END OF FILE ===================== */
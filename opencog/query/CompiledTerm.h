@@ -0,0 +1,81 @@
+/*
+ * CompiledTerm.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_COMPILED_TERM_H
+#define _OPENCOG_COMPILED_TERM_H
+
+#include <functional>
+
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog {
+
+/**
+ * A virtual term, compiled to a native closure over the variables of
+ * the pattern. Only the common, clear-box cases are compiled:
+ * GreaterThanLink, whose arguments are NumberNodes, variables, or
+ * PlusLink, MinusLink, TimesLink and DivideLink of these; and
+ * EqualLink and IdenticalLink, whose arguments are constant nodes or
+ * variables. Evaluating a compiled term on a grounding creates no
+ * atoms, and does not touch any atomspace; the usual way of
+ * evaluating a virtual term instantiates it in a scratch atomspace,
+ * first.
+ *
+ * A grounding that the closure cannot handle (say, a variable
+ * grounded by a link, which might have to be executed) gives UNKNOWN;
+ * the term must then be evaluated the usual way.
+ *
+ * The results are otherwise those of EvaluationLink::do_eval_scratch(),
+ * except for the arithmetic: the closure keeps full double precision,
+ * while the usual way puts each intermediate value in a NumberNode,
+ * and so rounds it to the precision of the node's name. Comparisons of
+ * values that differ only past that precision can thus come out
+ * differently.
+ */
+class CompiledTerm
+{
+public:
+	enum Result { FALSE_RESULT, TRUE_RESULT, UNKNOWN };
+
+	CompiledTerm(void) {}
+
+	/// Compile the term; returns false if it is not one of the
+	/// cases handled here.
+	bool compile(const Handle& term, const HandleSet& varset);
+
+	Result evaluate(const HandleMap& gnds) const { return _eval(gnds); }
+
+	// Each of these returns false if the grounding is not one that
+	// the closure can handle.
+	typedef std::function<bool(const HandleMap&, double&)> NumberFn;
+	typedef std::function<bool(const HandleMap&, Handle&)> AtomFn;
+
+private:
+	std::function<Result(const HandleMap&)> _eval;
+
+	static bool compile_number(const Handle&, const HandleSet&, NumberFn&);
+	static bool compile_atom(const Handle&, const HandleSet&, AtomFn&);
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_COMPILED_TERM_H
@@ -21,10 +21,32 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <typeinfo>
+
 #include "DefaultImplicator.h"
 
 using namespace opencog;
 
+/**
+ * Create a worker for a parallel search. The worker instantiates
+ * the implicand with its own Instantiator, and hands the results
+ * to this implicator.
+ *
+ * Classes derived from DefaultImplicator may carry state or override
+ * callbacks that a plain DefaultImplicator knows nothing about; they
+ * get a sequential search unless they provide their own workers.
+ */
+PatternMatchCallback* DefaultImplicator::clone_worker(void)
+{
+	if (typeid(*this) != typeid(DefaultImplicator)) return nullptr;
+
+	DefaultImplicator* worker = new DefaultImplicator(InitiateSearchCB::_as);
+	worker->implicand = implicand;
+	worker->max_results = max_results;
+	worker->_collector = this;
+	return worker;
+}
+
 #ifdef CACHED_IMPLICATOR
 
 DefaultImplicator* CachedDefaultImplicator::_cached_implicator = NULL;
@@ -42,7 +42,8 @@ class DefaultImplicator:
 		DefaultImplicator(AtomSpace* asp) :
 			Implicator(asp),
 			InitiateSearchCB(asp),
-			DefaultPatternMatchCB(asp) {}
+			DefaultPatternMatchCB(asp)
+		{ use_position_index(); }
 
 #ifdef CACHED_IMPLICATOR
 	virtual void ready(AtomSpace* asp)
@@ -66,6 +67,8 @@ class DefaultImplicator:
 		InitiateSearchCB::set_pattern(vars, pat);
 		DefaultPatternMatchCB::set_pattern(vars, pat);
 	}
+
+	virtual PatternMatchCallback* clone_worker(void);
 };
 
 
@@ -89,7 +92,15 @@ class AFImplicator:
 	                         const Pattern& pat)
 	{
 		InitiateSearchCB::set_pattern(vars, pat);
-		DefaultPatternMatchCB::set_pattern(vars, pat);
+		AttentionalFocusCB::set_pattern(vars, pat);
+	}
+
+	protected:
+	// Start the search only at atoms in the attentional focus.
+	virtual void get_candidates(HandleSeq& handle_set, Type t,
+	                            bool subclass = false)
+	{
+		get_af_candidates(handle_set, t, subclass);
 	}
 };
 
@@ -31,6 +31,8 @@
 #include <opencog/util/algorithm.h>
 
 #include "DefaultPatternMatchCB.h"
+#include "PatternProfile.h"
+#include "QueryBudget.h"
 
 using namespace opencog;
 
@@ -49,71 +51,108 @@ using namespace opencog;
 // The issue is that creating an atomspace is CPU-intensive, so its
 // cheaper to just have a cache of empty atomspaces, hanging around,
 // and ready to go. The code in this section implements this.
+//
+// Each thread keeps a short free list of its own, so that a search
+// grabs and releases its scratch space without taking any lock.
+// Only when the thread's list is empty (or full) does it go to the
+// shared overflow list, under the mutex. When a thread exits, its
+// free list is handed over to the overflow list, as far as that has
+// room; the rest is deleted.
 
 const bool TRANSIENT_SPACE = true;
-const int MAX_CACHED_TRANSIENTS = 8;
+const size_t MAX_LOCAL_TRANSIENTS = 4;
+const size_t MAX_CACHED_TRANSIENTS = 8;
 
 // Allocated storage for the transient atomspace cache static variables.
+thread_local DefaultPatternMatchCB::TransientFreeList
+	DefaultPatternMatchCB::s_local_transients;
 std::mutex DefaultPatternMatchCB::s_transient_cache_mutex;
 std::vector<AtomSpace*> DefaultPatternMatchCB::s_transient_cache;
+std::atomic<size_t> DefaultPatternMatchCB::s_transient_grabs(0);
+std::atomic<size_t> DefaultPatternMatchCB::s_transient_allocs(0);
 
-AtomSpace* DefaultPatternMatchCB::grab_transient_atomspace(AtomSpace* parent)
+DefaultPatternMatchCB::TransientFreeList::~TransientFreeList()
+{
+	{
+		std::lock_guard<std::mutex> cache_lock(s_transient_cache_mutex);
+		while (not spaces.empty() and
+		       s_transient_cache.size() < MAX_CACHED_TRANSIENTS)
+		{
+			s_transient_cache.push_back(spaces.back());
+			spaces.pop_back();
+		}
+	}
+	for (AtomSpace* as : spaces)
+		delete as;
+}
+
+AtomSpace* DefaultPatternMatchCB::grab_transient_atomspace(AtomSpace* parent,
+                                                           bool& fresh)
 {
 	AtomSpace* transient_atomspace = NULL;
+	s_transient_grabs++;
 
-	// See if the cache has one...
-	if (s_transient_cache.size() > 0)
+	// Try this thread's own cache first...
+	std::vector<AtomSpace*>& local = s_local_transients.spaces;
+	if (not local.empty())
 	{
-		// Grab the mutex lock.
-		std::unique_lock<std::mutex> cache_lock(s_transient_cache_mutex);
-
-		// Check to make sure the cache still has one now that we have
-		// the mutex.
-		if (s_transient_cache.size() > 0)
+		transient_atomspace = local.back();
+		local.pop_back();
+	}
+	else
+	{
+		// ... then the shared one.
+		std::lock_guard<std::mutex> cache_lock(s_transient_cache_mutex);
+		if (not s_transient_cache.empty())
 		{
-			// Pop the last transient atomspace off the cache stack.
 			transient_atomspace = s_transient_cache.back();
 			s_transient_cache.pop_back();
-
-			// Ready it for the new parent atomspace.
-			transient_atomspace->ready_transient(parent);
 		}
 	}
 
-	// If we didn't get one from the cache, then create a new one.
-	if (!transient_atomspace)
-		transient_atomspace = new AtomSpace(parent, TRANSIENT_SPACE);
+	fresh = (NULL == transient_atomspace);
+	if (fresh)
+	{
+		// If we didn't get one from the cache, then create a new one.
+		s_transient_allocs++;
+		return new AtomSpace(parent, TRANSIENT_SPACE);
+	}
 
+	// Ready it for the new parent atomspace.
+	transient_atomspace->ready_transient(parent);
 	return transient_atomspace;
 }
 
 void DefaultPatternMatchCB::release_transient_atomspace(AtomSpace* atomspace)
 {
-	bool atomspace_cached = false;
+	// Clear this transient atomspace. No one else can see it, so
+	// there is no need to hold any lock while doing this.
+	atomspace->clear_transient();
 
-	// If the cache is not full...
-	if (s_transient_cache.size() < MAX_CACHED_TRANSIENTS)
+	std::vector<AtomSpace*>& local = s_local_transients.spaces;
+	if (local.size() < MAX_LOCAL_TRANSIENTS)
 	{
-		// Grab the mutex lock.
-		std::unique_lock<std::mutex> cache_lock(s_transient_cache_mutex);
+		local.push_back(atomspace);
+		return;
+	}
 
-		// Check it again since we only now have the mutex locked.
+	{
+		std::lock_guard<std::mutex> cache_lock(s_transient_cache_mutex);
 		if (s_transient_cache.size() < MAX_CACHED_TRANSIENTS)
 		{
-			// Clear this transient atomspace.
-			atomspace->clear_transient();
-
-			// Place this transient into the cache.
 			s_transient_cache.push_back(atomspace);
-
-			// The atomspace has been cached.
-			atomspace_cached = true;
+			return;
 		}
 	}
 
 	// If we didn't cache the atomspace, then delete it.
-	if (!atomspace_cached)
-		delete atomspace;
+	delete atomspace;
+}
+
+void DefaultPatternMatchCB::grab_transient(AtomSpace* parent)
+{
+	_temp_aspace = grab_transient_atomspace(parent, _transient_fresh);
+	_transient_counted = false;
 }
 
 /* ======================================================== */
@@ -121,7 +160,7 @@ void DefaultPatternMatchCB::release_transient_atomspace(AtomSpace* atomspace)
 DefaultPatternMatchCB::DefaultPatternMatchCB(AtomSpace* as) :
 	_classserver(classserver())
 {
-	_temp_aspace = grab_transient_atomspace(as);
+	grab_transient(as);
 	_instor = new Instantiator(_temp_aspace);
 
 	_connectives.insert(SEQUENTIAL_AND_LINK);
@@ -151,7 +190,7 @@ DefaultPatternMatchCB::~DefaultPatternMatchCB()
 #ifdef CACHED_IMPLICATOR
 void DefaultPatternMatchCB::ready(AtomSpace* as)
 {
-	_temp_aspace = grab_transient_atomspace(as);
+	grab_transient(as);
 	_instor->ready(_temp_aspace);
 
 	_as = as;
@@ -185,6 +224,25 @@ void DefaultPatternMatchCB::set_pattern(const Variables& vars,
 	_have_variables = ! vars.varseq.empty();
 	_pattern_body = pat.body;
 	_globs = &pat.globby_terms;
+
+	// Count the scratch atomspace into the profile of the first search
+	// that uses it; a pattern with several components is set up once
+	// for each of them, but they all share this one.
+	if (not _transient_counted)
+	{
+		PatternProfile* prof = get_profile();
+		PM_PROFILE(prof, prof->transient_spaces++;
+		                 if (_transient_fresh) prof->transient_allocs++)
+		_transient_counted = true;
+	}
+
+	_compiled_terms.clear();
+	for (const Handle& term : pat.evaluatable_terms)
+	{
+		CompiledTerm ct;
+		if (ct.compile(term, vars.varset))
+			_compiled_terms.insert({term, ct});
+	}
 }
 
 /* ======================================================== */
@@ -523,6 +581,7 @@ bool DefaultPatternMatchCB::clause_match(const Handle& ptrn,
 		// is kind-of schizophrenic here.  Not sure what else to do.
 		_temp_aspace->clear();
 		TruthValuePtr tvp(EvaluationLink::do_eval_scratch(_as, grnd, _temp_aspace));
+		charge_transients();
 
 		DO_LOG({LAZY_LOG_FINE << "Clause_match evaluation yeilded tv"
 		              << std::endl << tvp->toString() << std::endl;})
@@ -558,13 +617,62 @@ bool DefaultPatternMatchCB::optional_clause_match(const Handle& ptrn,
 
 /* ======================================================== */
 
+/**
+ * A parallel-search worker may have seen optional clauses that the
+ * master never saw; the master must know about them, so that the
+ * AbsentLink semantics come out right.
+ */
+void DefaultPatternMatchCB::release_worker(PatternMatchCallback* pmc)
+{
+	DefaultPatternMatchCB* worker = dynamic_cast<DefaultPatternMatchCB*>(pmc);
+	if (worker and worker->_optionals_present)
+		_optionals_present = true;
+	delete pmc;
+}
+
+/* ======================================================== */
+
 IncomingSet DefaultPatternMatchCB::get_incoming_set(const Handle& h)
 {
 	return h->getIncomingSet(_as);
 }
 
+/// link_match() accepts only links of the same type as the pattern,
+/// so only the links of that type, holding `h` in the same place as
+/// the pattern does, need to be offered. These are picked out of
+/// get_incoming_set(), so that a subclass that narrows or reorders
+/// the incoming set is obeyed. Callbacks that called
+/// use_position_index() get them from the atomspace instead, which
+/// has them ready if its position index is on.
+IncomingSet DefaultPatternMatchCB::get_incoming_by_position(const Handle& h,
+                                                            Type t, Arity pos)
+{
+	if (_use_position_index)
+		return _as->get_incoming_by_position(h, t, pos);
+
+	IncomingSet iset;
+	for (const LinkPtr& l : get_incoming_set(h))
+	{
+		if (l->getType() == t and pos < l->getArity() and
+		    l->getOutgoingAtom(pos) == h)
+			iset.emplace_back(l);
+	}
+	return iset;
+}
+
 /* ======================================================== */
 
+/// Charge the budget, if any, for the atoms that an evaluation left
+/// behind in the scratch atomspace, and count them in the profile.
+/// If that uses up the budget, the engine notices at its next step.
+void DefaultPatternMatchCB::charge_transients(void)
+{
+	QueryBudget* qb = get_budget();
+	if (qb) qb->charge_transients(_temp_aspace->get_size());
+	PatternProfile* prof = get_profile();
+	PM_PROFILE(prof, prof->transient_atoms += _temp_aspace->get_size())
+}
+
 bool DefaultPatternMatchCB::eval_term(const Handle& virt,
                                       const HandleMap& gnds)
 {
@@ -573,7 +681,15 @@ bool DefaultPatternMatchCB::eval_term(const Handle& virt,
 	// python for the actual evaluation. We don't want to put the
 	// proposed grounding into the "real" atomspace, because the
 	// grounding might be insane.  So we put it here. This is probably
-	// not very efficient, but will do for now...
+	// not very efficient, but will do for now... The common cases
+	// were compiled when the pattern was set, and need none of this.
+	auto ct = _compiled_terms.find(virt);
+	if (_compiled_terms.end() != ct)
+	{
+		CompiledTerm::Result r = ct->second.evaluate(gnds);
+		if (CompiledTerm::UNKNOWN != r)
+			return CompiledTerm::TRUE_RESULT == r;
+	}
 
 	Handle gvirt(_instor->instantiate(virt, gnds));
 
@@ -632,6 +748,7 @@ bool DefaultPatternMatchCB::eval_term(const Handle& virt,
 		try
 		{
 			tvp = EvaluationLink::do_eval_scratch(_as, gvirt, _temp_aspace, true);
+			charge_transients();
 		}
 		catch (const NotEvaluatableException& ex)
 		{
@@ -25,10 +25,15 @@
 #ifndef _OPENCOG_DEFAULT_PATTERN_MATCH_H
 #define _OPENCOG_DEFAULT_PATTERN_MATCH_H
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 #include <opencog/atoms/base/types.h>
 #include <opencog/atoms/base/Quotation.h>
 #include <opencog/atomspace/AtomSpace.h>
 #include <opencog/atoms/execution/Instantiator.h>
+#include <opencog/query/CompiledTerm.h>
 #include <opencog/query/PatternMatchCallback.h>
 #include <opencog/query/PatternMatchEngine.h>
 
@@ -55,6 +60,11 @@ namespace opencog {
 class DefaultPatternMatchCB : public virtual PatternMatchCallback
 {
 	public:
+		/// Process-wide counts of the scratch atomspaces handed out
+		/// to searches, and of how many of those had to be allocated.
+		static size_t transient_grabs(void) { return s_transient_grabs; }
+		static size_t transient_allocs(void) { return s_transient_allocs; }
+
 		DefaultPatternMatchCB(AtomSpace*);
 		~DefaultPatternMatchCB();
 		virtual void set_pattern(const Variables&, const Pattern&);
@@ -77,6 +87,17 @@ class DefaultPatternMatchCB : public virtual PatternMatchCallback
 		                                   const HandleMap&);
 
 		virtual IncomingSet get_incoming_set(const Handle&);
+		virtual IncomingSet get_incoming_by_position(const Handle&,
+		                                             Type, Arity);
+
+		/**
+		 * Have get_incoming_by_position() ask the atomspace (and its
+		 * position index, if on), instead of filtering
+		 * get_incoming_set().  Only for callbacks that use the plain
+		 * incoming set; a subclass that overrides get_incoming_set()
+		 * must not turn this on.
+		 */
+		void use_position_index(bool on = true) { _use_position_index = on; }
 
 		/**
 		 * Called when a virtual link is encountered. Returns false
@@ -91,6 +112,8 @@ class DefaultPatternMatchCB : public virtual PatternMatchCallback
 		}
 
 		bool optionals_present(void) { return _optionals_present; }
+
+		virtual void release_worker(PatternMatchCallback*);
 	protected:
 
 		ClassServer& _classserver;
@@ -99,6 +122,7 @@ class DefaultPatternMatchCB : public virtual PatternMatchCallback
 		const HandleSet* _dynamic = NULL;
 		bool _have_evaluatables = false;
 		const HandleSet* _globs = NULL;
+		bool _use_position_index = false;
 
 		bool _have_variables;
 		Handle _pattern_body;
@@ -120,12 +144,31 @@ class DefaultPatternMatchCB : public virtual PatternMatchCallback
 		// The transient atomspace cache. The goal here is to
 		// avoid the overhead of constantly creating/deleting
 		// the temp atomspaces above. So instead, just keep a
-		// cache of empty ones, ready to go.
+		// cache of empty ones, ready to go. Each thread has a
+		// free list of its own, so that grabbing and releasing
+		// takes no lock; the shared overflow list only holds
+		// the ones that a thread could not keep.
+		struct TransientFreeList
+		{
+			std::vector<AtomSpace*> spaces;
+			~TransientFreeList();
+		};
+		static thread_local TransientFreeList s_local_transients;
 		static std::mutex s_transient_cache_mutex;
 		static std::vector<AtomSpace*> s_transient_cache;
-		static AtomSpace* grab_transient_atomspace(AtomSpace* parent);
+		static std::atomic<size_t> s_transient_grabs;
+		static std::atomic<size_t> s_transient_allocs;
+		static AtomSpace* grab_transient_atomspace(AtomSpace* parent,
+		                                           bool& fresh);
 		static void release_transient_atomspace(AtomSpace* atomspace);
 
+		// Whether the temp atomspace had to be allocated, rather than
+		// taken from the cache, and whether that was already counted
+		// in the profile.
+		bool _transient_fresh;
+		bool _transient_counted;
+		void grab_transient(AtomSpace* parent);
+
 #ifdef CACHED_IMPLICATOR
 		virtual void ready(AtomSpace*);
 		virtual void clear();
@@ -133,7 +176,12 @@ class DefaultPatternMatchCB : public virtual PatternMatchCallback
 		// Crisp-logic evaluation of evaluatable terms
 		std::set<Type> _connectives;
 		bool eval_term(const Handle& pat, const HandleMap& gnds);
+
+		// The virtual terms of the pattern that can be evaluated
+		// natively, without a scratch atomspace; see CompiledTerm.h.
+		std::unordered_map<Handle, CompiledTerm> _compiled_terms;
 		bool eval_sentence(const Handle& pat, const HandleMap& gnds);
+		void charge_transients(void);
 
 		bool _optionals_present = false;
 		AtomSpace* _as;
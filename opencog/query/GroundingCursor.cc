@@ -0,0 +1,248 @@
+/*
+ * GroundingCursor.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/atoms/base/ClassServer.h>
+#include <opencog/atomspace/AtomSpace.h>
+#include <opencog/atoms/execution/Instantiator.h>
+#include <opencog/atoms/pattern/BindLink.h>
+
+#include "DefaultPatternMatchCB.h"
+#include "GroundingCursor.h"
+#include "InitiateSearchCB.h"
+
+using namespace opencog;
+
+size_t GroundingCursor::queue_size = 64;
+
+namespace opencog {
+
+/**
+ * The callback used by the search thread. It builds the result for
+ * each grounding, drops duplicates, skips the offset, and hands the
+ * rest to the cursor, one at a time.
+ */
+class CursorCB :
+	public virtual InitiateSearchCB,
+	public virtual DefaultPatternMatchCB
+{
+	private:
+		GroundingCursor* _cursor;
+		Instantiator _inst;
+		HandleSeq _varseq;
+		UnorderedHandleSet _seen;
+		size_t _skip;
+		size_t _left;
+
+	public:
+		CursorCB(GroundingCursor* cur, AtomSpace* result_as) :
+			InitiateSearchCB(cur->_as), DefaultPatternMatchCB(cur->_as),
+			_cursor(cur), _inst(result_as),
+			_skip(cur->_offset), _left(cur->_limit)
+		{ use_position_index(); }
+
+		virtual void set_pattern(const Variables& vars,
+		                         const Pattern& pat)
+		{
+			_varseq = vars.varseq;
+			InitiateSearchCB::set_pattern(vars, pat);
+			DefaultPatternMatchCB::set_pattern(vars, pat);
+		}
+
+		virtual bool grounding(const HandleMap &var_soln,
+		                       const HandleMap &term_soln)
+		{
+			return report(make_result(var_soln));
+		}
+
+		Handle make_result(const HandleMap &var_soln);
+		bool report(const Handle&);
+		bool found_any(void) const { return not _seen.empty(); }
+};
+
+}
+
+Handle CursorCB::make_result(const HandleMap &var_soln)
+{
+	const Handle& implicand = _cursor->_implicand;
+	if (implicand)
+	{
+		// Ill-formed instantiations are ignored, exactly as the
+		// Implicator does.
+		try {
+			return _inst.instantiate(implicand, var_soln, true);
+		} catch(...) {}
+		return Handle::UNDEFINED;
+	}
+
+	if (1 == _varseq.size())
+		return var_soln.at(_varseq[0]);
+
+	HandleSeq vargnds;
+	for (const Handle& hv : _varseq)
+		vargnds.push_back(var_soln.at(hv));
+
+	if (_cursor->_add_results)
+		return _cursor->_as->add_link(LIST_LINK, vargnds);
+	return createLink(vargnds, LIST_LINK);
+}
+
+/// Return true to halt the search.
+bool CursorCB::report(const Handle& h)
+{
+	if (nullptr == h) return false;
+	if (not _seen.insert(h).second) return false;
+
+	if (0 < _skip)
+	{
+		_skip--;
+		return false;
+	}
+
+	if (_cursor->push(h)) return true;
+	return 0 == --_left;
+}
+
+// ===========================================================
+
+GroundingCursor::GroundingCursor(AtomSpace* as, const Handle& query,
+                                 size_t offset, size_t limit,
+                                 bool add_results) :
+	_as(as), _offset(offset), _limit(limit), _add_results(add_results),
+	_count(0), _finished(false), _closed(false)
+{
+	if (nullptr == query)
+		throw InvalidParamException(TRACE_INFO,
+			"GroundingCursor: expecting a query, got null");
+
+	Type qt = query->getType();
+	if (BIND_LINK == qt)
+	{
+		BindLinkPtr bl(BindLinkCast(query));
+		if (nullptr == bl)
+			bl = createBindLink(*LinkCast(query));
+		_implicand = bl->get_implicand();
+		_pattern = bl;
+
+		// The instantiator always adds what it builds to some
+		// atomspace; give it one that goes away with the cursor.
+		if (not add_results)
+			_scratch.reset(new AtomSpace(as, true));
+	}
+	else if (classserver().isA(qt, PATTERN_LINK) and DUAL_LINK != qt)
+	{
+		_pattern = PatternLinkCast(query);
+		if (nullptr == _pattern)
+			_pattern = createPatternLink(*LinkCast(query));
+	}
+	else
+	{
+		throw InvalidParamException(TRACE_INFO,
+			"GroundingCursor: expecting a BindLink or a GetLink, got %s",
+			query->toShortString().c_str());
+	}
+
+	if (0 == _limit)
+		_finished = true;
+	else
+		_search = std::thread(&GroundingCursor::search, this);
+}
+
+GroundingCursor::~GroundingCursor()
+{
+	close();
+	if (_search.joinable()) _search.join();
+}
+
+void GroundingCursor::search(void)
+{
+	try
+	{
+		CursorCB cb(this, _scratch ? _scratch.get() : _as);
+		_pattern->satisfy(cb);
+
+		// A BindLink consisting only of absent clauses fires when
+		// nothing at all was found; see do_imply() for the details.
+		const Pattern& pat = _pattern->get_pattern();
+		if (_implicand and not cb.found_any()
+		    and 0 == pat.mandatory.size() and 0 < pat.optionals.size()
+		    and not cb.optionals_present())
+		{
+			cb.report(cb.make_result(HandleMap()));
+		}
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		_error = std::current_exception();
+	}
+
+	std::lock_guard<std::mutex> lck(_mtx);
+	_finished = true;
+	_cv.notify_all();
+}
+
+/// Called from the search thread. Waits for room in the queue;
+/// returns true if the cursor was closed in the meantime.
+bool GroundingCursor::push(const Handle& h)
+{
+	std::unique_lock<std::mutex> lck(_mtx);
+	_cv.wait(lck, [&]{ return _closed or _queue.size() < queue_size; });
+	if (_closed) return true;
+
+	_queue.push_back(h);
+	_cv.notify_all();
+	return false;
+}
+
+Handle GroundingCursor::next(void)
+{
+	std::unique_lock<std::mutex> lck(_mtx);
+	_cv.wait(lck, [&]{
+		return _finished or _closed or not _queue.empty(); });
+
+	if (_queue.empty())
+	{
+		if (_error and not _closed)
+		{
+			std::exception_ptr err = _error;
+			_error = nullptr;
+			std::rethrow_exception(err);
+		}
+		return Handle::UNDEFINED;
+	}
+
+	Handle h(_queue.front());
+	_queue.pop_front();
+	_count++;
+	_cv.notify_all();
+	return h;
+}
+
+void GroundingCursor::close(void)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	_closed = true;
+	_queue.clear();
+	_cv.notify_all();
+}
+
+/* ===================== END OF FILE ===================== */
@@ -0,0 +1,118 @@
+/*
+ * GroundingCursor.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_GROUNDING_CURSOR_H
+#define _OPENCOG_GROUNDING_CURSOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <opencog/atoms/pattern/PatternLink.h>
+
+namespace opencog {
+
+class AtomSpace;
+class CursorCB;
+
+/**
+ * class GroundingCursor -- hand out pattern-match results one by one.
+ *
+ * bindlink() and satisfying_set() run the search to completion, and
+ * wrap all of the results in a SetLink, which is added to the
+ * atomspace. For queries with very many groundings, that SetLink is
+ * both huge and unwanted. A cursor instead returns the results as the
+ * pattern matcher finds them, and does not collect them anywhere.
+ *
+ * The query may be a BindLink, in which case the results are the
+ * instantiated implicands, or any other PatternLink (e.g. a GetLink),
+ * in which case the results are the variable groundings, wrapped in
+ * a ListLink (in variable order) if there is more than one variable.
+ * Duplicate results are reported only once, as bindlink() does.
+ *
+ * The first `offset` results are skipped, and the search is halted
+ * as soon as `limit` results have been produced.
+ *
+ * Nothing is added to the atomspace unless `add_results` is set.
+ * Otherwise, BindLink implicands are instantiated into a transient
+ * atomspace that is owned by the cursor, and the ListLinks holding
+ * GetLink groundings are not placed in any atomspace at all.
+ *
+ * The pattern matcher is recursive, and cannot be suspended half-way
+ * through a search; so the search runs in its own thread, pausing
+ * whenever `queue_size` results are waiting to be picked up. Closing
+ * (or destroying) the cursor halts the search at the next grounding.
+ */
+class GroundingCursor
+{
+	friend class CursorCB;
+
+	public:
+		GroundingCursor(AtomSpace*, const Handle& query,
+		                size_t offset = 0, size_t limit = SIZE_MAX,
+		                bool add_results = false);
+		~GroundingCursor();
+
+		/// Return the next result, waiting for the search if needed.
+		/// Returns Handle::UNDEFINED once the search is exhausted.
+		/// Exceptions thrown by the search are re-thrown here.
+		Handle next(void);
+
+		/// Halt the search, and drop any results not yet returned.
+		void close(void);
+
+		/// The number of results returned by next(), so far.
+		size_t count(void) const { return _count; }
+
+		/// The number of results that may be waiting in the queue
+		/// before the search pauses.
+		static size_t queue_size;
+
+	private:
+		AtomSpace* _as;
+		std::unique_ptr<AtomSpace> _scratch;
+		PatternLinkPtr _pattern;
+		Handle _implicand;
+		size_t _offset;
+		size_t _limit;
+		bool _add_results;
+		size_t _count;
+
+		// Shared with the search thread.
+		std::mutex _mtx;
+		std::condition_variable _cv;
+		std::deque<Handle> _queue;
+		bool _finished;
+		bool _closed;
+		std::exception_ptr _error;
+		std::thread _search;
+
+		void search(void);
+		bool push(const Handle&);
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_GROUNDING_CURSOR_H
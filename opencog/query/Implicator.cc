@@ -23,17 +23,25 @@
 
 #include <opencog/atomspace/AtomSpace.h>
 #include <opencog/atoms/pattern/BindLink.h>
+#include <opencog/atomutils/FindUtils.h>
 
 #include "BindLinkAPI.h"
 #include "DefaultImplicator.h"
 #include "PatternMatch.h"
+#include "PatternProfile.h"
+#include "QueryBudget.h"
+#include "Satisfier.h"
+#include "SearchPlan.h"
+#include "TypeStats.h"
 
 using namespace opencog;
 
 /**
  * This callback takes the reported grounding, runs it through the
  * instantiator, to create the implicand, and then records the result
- * in the `result_set`. Repeated solutions are skipped. If the number
+ * in the `result_set`. Repeated solutions are skipped; if the grounding
+ * gives the implicand variables the same values as an earlier one did,
+ * then it is skipped before instantiating anything. If the number
  * of unique results so far is less than `max_results`, it then returns
  * false, to search for more groundings.  (The engine will halt its
  * search for a grounding once an acceptable one has been found; so,
@@ -45,10 +53,32 @@ bool Implicator::grounding(const HandleMap &var_soln,
 {
 	// PatternMatchEngine::print_solution(term_soln,var_soln);
 
+	// Worker threads report to the implicator that started the search.
+	Implicator* coll = _collector ? _collector : this;
+
 	// Do not accept new solution if maximum number has been already reached
-	if (_result_set.size() >= max_results)
+	if (coll->num_results() >= max_results)
 		return true;
 
+	if (_scanned_implicand != implicand) scan_implicand();
+	if (_skip_duplicates)
+	{
+		HandleSeq values;
+		values.reserve(_implicand_vars.size());
+		for (const Handle& v : _implicand_vars)
+		{
+			auto it = var_soln.find(v);
+			values.push_back(var_soln.end() == it ? Handle::UNDEFINED
+			                                      : it->second);
+		}
+		if (not coll->first_grounding(values))
+		{
+			PatternProfile* prof = get_profile();
+			PM_PROFILE(prof, prof->duplicate_groundings++)
+			return false;
+		}
+	}
+
 	// Ignore the case where the URE creates ill-formed links (due to
 	// rules producing nothing). Ideally this should be treated as a
 	// user error, that is the user should design rule pre-conditions
@@ -57,15 +87,21 @@ bool Implicator::grounding(const HandleMap &var_soln,
 	// issue #950 and pull req #962. XXX FIXME later.
 	try {
 		Handle h = inst.instantiate(implicand, var_soln, true);
-		insert_result(h);
+		coll->insert_result(h);
 	} catch(...) {}
 
 	// If we found as many as we want, then stop looking for more.
-	return (_result_set.size() >= max_results);
+	return (coll->num_results() >= max_results);
 }
 
 void Implicator::insert_result(const Handle& h)
 {
+	std::lock_guard<std::mutex> lck(_result_mutex);
+
+	// Several workers may race past the check in grounding(); only
+	// the first ones to get here are kept.
+	if (_result_set.size() >= max_results) return;
+
 	if (h and _result_set.end() == _result_set.find(h))
 	{
 		_result_set.insert(h);
@@ -73,6 +109,71 @@ void Implicator::insert_result(const Handle& h)
 	}
 }
 
+size_t Implicator::num_results(void)
+{
+	std::lock_guard<std::mutex> lck(_result_mutex);
+	return _result_set.size();
+}
+
+/// Record the values given to the implicand variables; return false
+/// if some earlier grounding already gave them these same values.
+bool Implicator::first_grounding(const HandleSeq& values)
+{
+	std::lock_guard<std::mutex> lck(_result_mutex);
+	return _instantiated.insert(values).second;
+}
+
+/// Find the variables and globs that the instantiator will substitute
+/// into the implicand. Executable or random terms could instantiate
+/// differently each time, even with the same values; for those, every
+/// grounding is instantiated, as before.
+void Implicator::scan_implicand(void)
+{
+	_scanned_implicand = implicand;
+	_implicand_vars.clear();
+	_skip_duplicates = implicand and
+		not contains_atomtype(implicand, EXECUTION_OUTPUT_LINK) and
+		not contains_atomtype(implicand, DEFINED_SCHEMA_NODE) and
+		not contains_atomtype(implicand, RANDOM_NUMBER_LINK) and
+		not contains_atomtype(implicand, RANDOM_CHOICE_LINK) and
+		not contains_atomtype(implicand, TIME_LINK) and
+		not contains_atomtype(implicand, SLEEP_LINK) and
+		not contains_atomtype(implicand, SATISFYING_LINK);
+	if (not _skip_duplicates) return;
+
+	FindAtoms fv(VARIABLE_NODE);
+	fv.search_set(implicand);
+	FindAtoms fg(GLOB_NODE);
+	fg.search_set(implicand);
+	_implicand_vars.insert(_implicand_vars.end(),
+	                       fv.varset.begin(), fv.varset.end());
+	_implicand_vars.insert(_implicand_vars.end(),
+	                       fg.varset.begin(), fg.varset.end());
+}
+
+size_t Implicator::GroundingHash::operator()(const HandleSeq& hs) const
+{
+	size_t h = hs.size();
+	for (const Handle& g : hs)
+		h ^= hash_value(g) + 0x9e3779b9 + (h << 6) + (h >> 2);
+	return h;
+}
+
+// Glob groundings are ListLinks made afresh for each grounding, so the
+// values are compared by content.
+bool Implicator::GroundingEqual::operator()(const HandleSeq& a,
+                                            const HandleSeq& b) const
+{
+	if (a.size() != b.size()) return false;
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		if (a[i] == b[i]) continue;
+		if (nullptr == a[i] or nullptr == b[i]) return false;
+		if (*a[i] != *b[i]) return false;
+	}
+	return true;
+}
+
 namespace opencog
 {
 
@@ -123,11 +224,16 @@ static Handle do_imply(AtomSpace* as,
 	// Theoretical background: the atomspace can be thought of as a
 	// Kripke frame: it holds everything we know "right now". The
 	// AbsentLink is a check for what we don't know, right now.
+	//
+	// A search that ran out of budget was not exhaustive; absence
+	// was not established.
 	const Pattern& pat = bl->get_pattern();
 	DefaultPatternMatchCB* intu =
 		dynamic_cast<DefaultPatternMatchCB*>(&impl);
+	QueryBudget* budget = impl.get_budget();
 	if (0 == pat.mandatory.size() and 0 < pat.optionals.size()
-	    and not intu->optionals_present())
+	    and not intu->optionals_present()
+	    and not (budget and budget->stopped()))
 	{
 		Handle h = impl.inst.execute(impl.implicand, true);
 		impl.insert_result(h);
@@ -159,6 +265,86 @@ Handle bindlink(AtomSpace* as, const Handle& hbindlink, size_t max_results)
 	return do_imply(as, hbindlink, impl);
 }
 
+/**
+ * Run a BindLink as bindlink() does, or any other PatternLink as
+ * satisfying_set() does, with the given profile and budget (either
+ * may be null). The caching implicator is never used; it would not
+ * hand out either one.
+ */
+static Handle run_query(AtomSpace* as, const Handle& hquery,
+                        size_t max_results,
+                        PatternProfile* prof, QueryBudget* budget)
+{
+	if (BIND_LINK == hquery->getType())
+	{
+		DefaultImplicator impl(as);
+		impl.max_results = max_results;
+		impl.profile = prof;
+		impl.budget = budget;
+		return do_imply(as, hquery, impl);
+	}
+
+	PatternLinkPtr pl(PatternLinkCast(hquery));
+	if (nullptr == pl)
+		pl = createPatternLink(*LinkCast(hquery));
+
+	SatisfyingSet sater(as);
+	sater.max_results = max_results;
+	sater.profile = prof;
+	sater.budget = budget;
+	pl->satisfy(sater);
+
+	HandleSeq satvec(sater._satisfying_set.begin(),
+	                 sater._satisfying_set.end());
+	return as->add_link(SET_LINK, satvec);
+}
+
+/**
+ * Run the query with profiling turned on.
+ */
+Handle profile_query(AtomSpace* as, const Handle& hquery,
+                     PatternProfile& prof, size_t max_results)
+{
+	prof.clear();
+	ProfileTimer total(&prof.total_seconds);
+	return run_query(as, hquery, max_results, &prof, nullptr);
+}
+
+/**
+ * Run the query within the given budget. If the budget runs out, the
+ * results found so far are returned, and `budget.status` says which
+ * limit was hit.
+ */
+Handle budgeted_query(AtomSpace* as, const Handle& hquery,
+                      QueryBudget& budget, size_t max_results)
+{
+	budget.reset();
+	return run_query(as, hquery, max_results, nullptr, &budget);
+}
+
+/**
+ * Explain how the query would be searched. BindLinks and all other
+ * PatternLinks are started in exactly the same way, so the plain
+ * satisfying-set callback will do for both. The joins are costed
+ * with the statistics of the atomspace, which are gathered on the
+ * first explanation, and then kept up to date.
+ */
+SearchPlan explain_query(AtomSpace* as, const Handle& hquery)
+{
+	PatternLinkPtr pl(PatternLinkCast(hquery));
+	if (nullptr == pl)
+	{
+		if (BIND_LINK == hquery->getType())
+			pl = createBindLink(*LinkCast(hquery));
+		else
+			pl = createPatternLink(*LinkCast(hquery));
+	}
+
+	SatisfyingSet sater(as);
+	sater.type_stats = TypeStats::attach(as);
+	return pl->explain(sater);
+}
+
 /**
  * Attentional Focus specific PatternMatchCallback implementation
  */
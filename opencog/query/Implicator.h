@@ -24,6 +24,8 @@
 #ifndef _OPENCOG_IMPLICATOR_H
 #define _OPENCOG_IMPLICATOR_H
 
+#include <mutex>
+#include <unordered_set>
 #include <vector>
 
 #include <opencog/atomspace/AtomSpace.h>
@@ -50,6 +52,17 @@ namespace opencog {
  * grounding.  A set of grounded expressions is created in 'result_set'.
  * Note that the callback may be called many times reporting the same
  * results. In that case the 'result_set' will contain unique solutions.
+ * Groundings that give the same values to the variables of the
+ * implicand are not instantiated again, unless the implicand runs
+ * code, picks random numbers, reads the clock, sleeps or runs a nested
+ * query, any of which might give something else (or do something)
+ * each time.
+ *
+ * During a parallel search, each worker thread has its own Implicator
+ * (and thus its own Instantiator); the workers hand their results to
+ * the `_collector`, the Implicator that started the search. Results
+ * are inserted under a lock, so that the collector sees a consistent
+ * result set, and so that `max_results` is respected across threads.
  */
 class Implicator :
 	public virtual PatternMatchCallback
@@ -58,8 +71,35 @@ class Implicator :
 		UnorderedHandleSet _result_set;
 		HandleSeq _result_list;
 
+		Implicator* _collector;
+		std::mutex _result_mutex;
+		size_t num_results(void);
+
+		// The values of the implicand variables, for each grounding
+		// that was instantiated; kept by the collector.
+		struct GroundingHash
+		{
+			size_t operator()(const HandleSeq&) const;
+		};
+		struct GroundingEqual
+		{
+			bool operator()(const HandleSeq&, const HandleSeq&) const;
+		};
+		std::unordered_set<HandleSeq, GroundingHash, GroundingEqual>
+			_instantiated;
+		bool first_grounding(const HandleSeq&);
+
+		// The variables and globs of the implicand, and whether
+		// groundings can be skipped by their values at all.
+		Handle _scanned_implicand;
+		HandleSeq _implicand_vars;
+		bool _skip_duplicates;
+		void scan_implicand(void);
+
 	public:
-		Implicator(AtomSpace* as) : inst(as), max_results(SIZE_MAX) {}
+		Implicator(AtomSpace* as) :
+			_collector(nullptr), _skip_duplicates(false),
+			inst(as), max_results(SIZE_MAX) {}
 		Instantiator inst;
 		Handle implicand;
 		size_t max_results;
@@ -69,7 +109,10 @@ class Implicator :
 		{ inst.ready(asp); max_results = SIZE_MAX; }
 
 		virtual void clear()
-		{ inst.clear(); implicand = Handle::UNDEFINED; }
+		{
+			inst.clear(); implicand = Handle::UNDEFINED;
+			_instantiated.clear(); _scanned_implicand = Handle::UNDEFINED;
+		}
 #endif
 
 		virtual bool grounding(const HandleMap &var_soln,
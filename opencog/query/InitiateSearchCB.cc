@@ -21,10 +21,16 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <atomic>
+#include <exception>
+#include <thread>
+
 #include <opencog/atomspace/AtomSpace.h>
 
 #include <opencog/atoms/core/DefineLink.h>
 #include <opencog/atoms/core/LambdaLink.h>
+#include <opencog/atoms/NumberNode.h>
+#include <opencog/atoms/TypeNode.h>
 #include <opencog/atoms/execution/EvaluationLink.h>
 #include <opencog/atoms/pattern/PatternLink.h>
 #include <opencog/atomutils/FindUtils.h>
@@ -32,6 +38,9 @@
 
 #include "InitiateSearchCB.h"
 #include "PatternMatchEngine.h"
+#include "PatternProfile.h"
+#include "QueryBudget.h"
+#include "SearchPlan.h"
 
 using namespace opencog;
 
@@ -44,7 +53,16 @@ using namespace opencog;
 
 /* ======================================================== */
 
+// Parallel search is opt-in; by default, all searches are sequential.
+unsigned int InitiateSearchCB::default_search_threads = 1;
+size_t InitiateSearchCB::parallel_min_candidates = 1000;
+
 InitiateSearchCB::InitiateSearchCB(AtomSpace* as) :
+	search_threads(0),
+	profile(nullptr),
+	budget(nullptr),
+	number_index(NumberIndex::attached(as)),
+	type_stats(nullptr),
 	_classserver(classserver())
 {
 #ifdef CACHED_IMPLICATOR
@@ -211,6 +229,14 @@ InitiateSearchCB::find_starter_recursive(const Handle& h, size_t& depth,
 
 		Handle s(find_starter_recursive(hunt, brdepth, sbr, brwid));
 
+		// A constant directly under this link can only be grounded by
+		// a search that walks upwards, to links of this type; so count
+		// only those.  This is a far better estimate than the full
+		// incoming set, when a few constants are shared by many
+		// different kinds of links.
+		if (s == hunt and CHOICE_LINK != t)
+			brwid = hunt->getIncomingSetSizeByType(t);
+
 		if (s)
 		{
 			// Each ChoiceLink is potentially disconnected from the rest
@@ -388,8 +414,9 @@ bool InitiateSearchCB::neighbor_search(PatternMatchEngine *pme)
 		// This should be calling the over-loaded virtual method
 		// get_incoming_set(), so that, e.g. it gets sorted by attentional
 		// focus in the AttentionalFocusCB class...
-		IncomingSet iset = get_incoming_set(best_start);
+		IncomingSet iset = get_start_incoming(best_start, _starter_term);
 		size_t sz = iset.size();
+		note_start(pme, "neighbor", sz, best_start);
 		for (size_t i = 0; i < sz; i++)
 		{
 			Handle h(iset[i]);
@@ -408,6 +435,45 @@ bool InitiateSearchCB::neighbor_search(PatternMatchEngine *pme)
 	return false;
 }
 
+/* ======================================================== */
+/**
+ * The incoming set of the search start, or the part of it that can
+ * ground the starter term: if the starter term is an ordered link,
+ * holding the start at one position only, then just the links of the
+ * same type, holding the start at the same position, can do so.
+ * Unordered links, ChoiceLinks, globs and quotes leave the position
+ * of the start in the grounding open; the whole incoming set is then
+ * used.
+ */
+IncomingSet InitiateSearchCB::get_start_incoming(const Handle& start,
+                                                 const Handle& term)
+{
+	if (not term or not term->isLink())
+		return get_incoming_set(start);
+
+	Type tt = term->getType();
+	if (CHOICE_LINK == tt or
+	    _classserver.isA(tt, UNORDERED_LINK) or
+	    Quotation::is_quotation_type(tt))
+		return get_incoming_set(start);
+
+	const HandleSeq& oset = term->getOutgoingSet();
+	Arity arity = oset.size();
+	Arity pos = arity;
+	for (Arity i = 0; i < arity; i++)
+	{
+		Type ot = oset[i]->getType();
+		if (GLOB_NODE == ot or Quotation::is_quotation_type(ot))
+			return get_incoming_set(start);
+		if (oset[i] != start) continue;
+		if (pos < arity) return get_incoming_set(start);
+		pos = i;
+	}
+	if (arity == pos) return get_incoming_set(start);
+
+	return get_incoming_by_position(start, tt, pos);
+}
+
 /* ======================================================== */
 /**
  * Search for solutions/groundings over all of the AtomSpace, using
@@ -501,9 +567,22 @@ bool InitiateSearchCB::initiate_search(PatternMatchEngine *pme)
 {
 	jit_analyze(pme);
 
+	QueryBudget* qb = pme->get_budget();
+	if (qb) qb->begin();
+
+	bool found;
+	if (number_index)
+	{
+		DO_LOG({logger().fine("Attempt to use number-range search");})
+		_search_fail = false;
+		found = range_search(pme);
+		if (found) return true;
+		if (not _search_fail) return false;
+	}
+
 	DO_LOG({logger().fine("Attempt to use node-neighbor search");})
 	_search_fail = false;
-	bool found = neighbor_search(pme);
+	found = neighbor_search(pme);
 	if (found) return true;
 	if (not _search_fail) return false;
 
@@ -541,6 +620,172 @@ bool InitiateSearchCB::initiate_search(PatternMatchEngine *pme)
 	return found;
 }
 
+/* ======================================================== */
+/**
+ * Find the bounds that the mandatory GreaterThanLink clauses put on
+ * the variable, if it is typed to NumberNode. For example,
+ * (GreaterThan $x (Number 3)), (GreaterThan (Number 10) $x) and
+ * (Not (GreaterThan $x (Number 10))) bound $x to (3, 10]. Returns
+ * false if the variable is not bounded.
+ */
+bool InitiateSearchCB::number_bounds(const Handle& var,
+                                     NumberIndex::Bounds& bounds)
+{
+	auto tit = _variables->_simple_typemap.find(var);
+	if (_variables->_simple_typemap.end() == tit) return false;
+	const std::set<Type>& typeset = tit->second;
+	if (1 != typeset.size() or NUMBER_NODE != *typeset.begin())
+		return false;
+
+	for (const Handle& cl : _pattern->mandatory)
+	{
+		Handle gt(cl);
+		bool negated = false;
+		if (NOT_LINK == gt->getType() and 1 == gt->getArity())
+		{
+			gt = gt->getOutgoingAtom(0);
+			negated = true;
+		}
+		if (GREATER_THAN_LINK != gt->getType() or 2 != gt->getArity())
+			continue;
+
+		const Handle& left = gt->getOutgoingAtom(0);
+		const Handle& right = gt->getOutgoingAtom(1);
+		if (left == var)
+		{
+			NumberNodePtr nn(NumberNodeCast(right));
+			if (nullptr == nn) continue;
+			if (negated) bounds.below(nn->get_value(), false);
+			else bounds.above(nn->get_value(), true);
+		}
+		else if (right == var)
+		{
+			NumberNodePtr nn(NumberNodeCast(left));
+			if (nullptr == nn) continue;
+			if (negated) bounds.above(nn->get_value(), false);
+			else bounds.below(nn->get_value(), true);
+		}
+	}
+	return bounds.bounded();
+}
+
+/**
+ * The size of the incoming set that neighbor_search() would start
+ * with; SIZE_MAX if it cannot be used, and zero if it has several
+ * choices to make.
+ */
+size_t InitiateSearchCB::neighbor_width(void)
+{
+	if (_pattern->clauses.empty()) return SIZE_MAX;
+
+	bool try_all = true;
+	for (const Handle& m : _pattern->mandatory)
+	{
+		if (0 == _pattern->evaluatable_holders.count(m))
+		{
+			try_all = false;
+			break;
+		}
+	}
+	const HandleSeq& clauses =
+		try_all ?  _pattern->cnf_clauses :  _pattern->mandatory;
+
+	size_t bestclause;
+	Handle term;
+	Handle best_start = find_thinnest(clauses, _pattern->evaluatable_holders,
+	                                  term, bestclause);
+	if (not _choices.empty()) return 0;
+	if (nullptr == best_start) return SIZE_MAX;
+	return best_start->getIncomingSetSize();
+}
+
+/**
+ * Initiate a search by looping over the NumberNodes that a variable
+ * can be grounded by, when the variable is typed to NumberNode and
+ * bounded by GreaterThanLink clauses; the numbers come from the
+ * number_index. The search starts at a clause holding the variable.
+ * If the variable with the fewest candidates still has more than
+ * the neighbor search would start with, the neighbor search is left
+ * to do the job.
+ */
+bool InitiateSearchCB::range_search(PatternMatchEngine *pme)
+{
+	_search_fail = true;
+	if (nullptr == number_index) return false;
+
+	const HandleSeq& clauses = _pattern->mandatory;
+	bool all_clauses_are_evaluatable = true;
+	for (const Handle& cl : clauses)
+	{
+		if (0 < _pattern->evaluatable_holders.count(cl)) continue;
+		all_clauses_are_evaluatable = false;
+		break;
+	}
+
+	// The range search has to start with fewer candidates than the
+	// neighbor search would, so there is no point in counting more
+	// numbers than that. The width is only worked out once there is
+	// something to count.
+	bool have_width = false;
+	size_t count = SIZE_MAX;
+	NumberIndex::Bounds best;
+	Handle root, var;
+	for (const Handle& v : _variables->varseq)
+	{
+		NumberIndex::Bounds bounds;
+		if (not number_bounds(v, bounds)) continue;
+
+		// Start at a clause that can be grounded, unless there are none.
+		Handle cl;
+		for (const Handle& c : clauses)
+		{
+			if (not all_clauses_are_evaluatable and
+			    0 < _pattern->evaluatable_holders.count(c)) continue;
+			if (not is_unquoted_in_tree(c, v)) continue;
+			cl = c;
+			break;
+		}
+		if (nullptr == cl) continue;
+
+		if (not have_width)
+		{
+			have_width = true;
+			count = neighbor_width();
+			if (0 == count) return false;
+		}
+
+		size_t num = number_index->count(bounds, count);
+		if (num < count)
+		{
+			count = num;
+			best = bounds;
+			root = cl;
+			var = v;
+		}
+	}
+	if (nullptr == var) return false;
+
+	_search_fail = false;
+	_root = root;
+	_starter_term = var;
+
+	DO_LOG({LAZY_LOG_FINE << "Range search on " << var->toShortString()
+	              << " in [" << best.lo << ", " << best.hi << "]";})
+
+	HandleSeq handle_set(number_index->range(best));
+	note_start(pme, "range", handle_set.size());
+
+	bool found;
+	if (parallel_search(pme, handle_set, found)) return found;
+
+	for (const Handle& h : handle_set)
+	{
+		bool found = pme->explore_neighborhood(_root, _starter_term, h);
+		if (found) return true;
+	}
+	return false;
+}
+
 /* ======================================================== */
 /**
  * Find the rarest link type contained in the clause, or one
@@ -576,6 +821,14 @@ void InitiateSearchCB::find_rarest(const Handle& clause,
 		find_rarest(h, rarest, count, quotation);
 }
 
+/* ======================================================== */
+
+void InitiateSearchCB::get_candidates(HandleSeq& handle_set, Type t,
+                                      bool subclass)
+{
+	_as->get_handles_by_type(handle_set, t, subclass);
+}
+
 /* ======================================================== */
 /**
  * Initiate a search by looping over all Links of the same type as one
@@ -626,7 +879,11 @@ bool InitiateSearchCB::link_type_search(PatternMatchEngine *pme)
 	Type ptype = _starter_term->getType();
 
 	HandleSeq handle_set;
-	_as->get_handles_by_type(handle_set, ptype);
+	get_candidates(handle_set, ptype);
+	note_start(pme, "link-type", handle_set.size());
+
+	bool found;
+	if (parallel_search(pme, handle_set, found)) return found;
 
 #ifdef DEBUG
 	size_t i = 0, hsz = handle_set.size();
@@ -642,6 +899,165 @@ bool InitiateSearchCB::link_type_search(PatternMatchEngine *pme)
 	return false;
 }
 
+/* ======================================================== */
+// Deep types.
+//
+// A variable with a deep type can only be grounded by atoms having the
+// shape given by its signature. For an ordered link of type L in the
+// signature, the groundings are links of type L, and every constant in
+// the signature sits at a known position in them. So the candidates
+// can be found by starting at the rarest constant, and walking up,
+// one level at a time, through the links holding it at the right
+// position.  Where there are no constants, the type index is used,
+// as for a simple type.
+
+static size_t sat_add(size_t a, size_t b)
+{
+	return (SIZE_MAX - a < b) ? SIZE_MAX : a + b;
+}
+
+/// Strip off the DefinedType and SignatureLink wrappers.
+static Handle unpack_deep(const Handle& spec)
+{
+	Handle deep(spec);
+	if (DEFINED_TYPE_NODE == deep->getType())
+		deep = DefineLink::get_definition(deep);
+	if (SIGNATURE_LINK == deep->getType())
+		deep = deep->getOutgoingAtom(0);
+	return deep;
+}
+
+static bool is_type_spec(Type t)
+{
+	return TYPE_NODE == t or TYPE_INH_NODE == t or TYPE_CO_INH_NODE == t
+		or TYPE_CHOICE == t or FUZZY_LINK == t;
+}
+
+/**
+ * An estimate of the number of atoms having the deep type `spec`;
+ * SIZE_MAX if they cannot be found (e.g. for TypeCoInheritanceNode,
+ * which allows any of the base types).
+ */
+size_t InitiateSearchCB::deep_width(const Handle& spec)
+{
+	Handle deep(unpack_deep(spec));
+	Type dt = deep->getType();
+
+	if (TYPE_NODE == dt or TYPE_INH_NODE == dt)
+	{
+		Type vt = TypeNodeCast(deep)->get_value();
+		return _as->get_num_atoms_of_type(vt, TYPE_INH_NODE == dt);
+	}
+	if (TYPE_CO_INH_NODE == dt or FUZZY_LINK == dt)
+		return SIZE_MAX;
+	if (TYPE_CHOICE == dt)
+	{
+		size_t num = 0;
+		for (const Handle& choice : deep->getOutgoingSet())
+			num = sat_add(num, deep_width(choice));
+		return num;
+	}
+
+	// A constant.
+	if (deep->isNode()) return 1;
+
+	Arity pos;
+	return deep_link_width(deep, pos);
+}
+
+/**
+ * The estimated number of links of the (ordered) link signature
+ * `deep`. If they are best found through the atom at some position,
+ * that position is returned in `pos`; else `pos` is set to the arity,
+ * and the type index is to be used.
+ */
+size_t InitiateSearchCB::deep_link_width(const Handle& deep, Arity& pos)
+{
+	Type dt = deep->getType();
+	size_t width = _as->get_num_atoms_of_type(dt);
+	const HandleSeq& dpo = deep->getOutgoingSet();
+	pos = dpo.size();
+	if (_classserver.isA(dt, UNORDERED_LINK)) return width;
+
+	for (Arity i = 0; i < dpo.size(); i++)
+	{
+		// A constant bounds the number of links exactly; for anything
+		// else, each of its groundings is assumed to have about one
+		// holder of this type.
+		Handle child(unpack_deep(dpo[i]));
+		size_t cw = (child->isNode() and not is_type_spec(child->getType())) ?
+			child->getIncomingSetSizeByType(dt) : deep_width(child);
+		if (cw < width)
+		{
+			width = cw;
+			pos = i;
+		}
+	}
+	return width;
+}
+
+/// Append the atoms that might have the deep type `spec`.
+void InitiateSearchCB::deep_candidates(HandleSeq& handle_set,
+                                       const Handle& spec)
+{
+	Handle deep(unpack_deep(spec));
+	Type dt = deep->getType();
+
+	if (TYPE_NODE == dt or TYPE_INH_NODE == dt)
+	{
+		Type vt = TypeNodeCast(deep)->get_value();
+		get_candidates(handle_set, vt, TYPE_INH_NODE == dt);
+		return;
+	}
+	if (TYPE_CHOICE == dt)
+	{
+		for (const Handle& choice : deep->getOutgoingSet())
+			deep_candidates(handle_set, choice);
+		return;
+	}
+	if (deep->isNode())
+	{
+		Handle h(_as->get_atom(deep));
+		if (h) handle_set.push_back(h);
+		return;
+	}
+
+	Arity pos;
+	deep_link_width(deep, pos);
+	if (deep->getArity() == pos)
+	{
+		get_candidates(handle_set, dt);
+		return;
+	}
+
+	HandleSeq below;
+	deep_candidates(below, deep->getOutgoingAtom(pos));
+	for (const Handle& h : below)
+		for (const LinkPtr& l : get_incoming_by_position(h, dt, pos))
+			handle_set.emplace_back(l);
+}
+
+/**
+ * The candidate groundings for the deep-typed variable `var`: those of
+ * each of its signatures, and the atoms of its simple types, if any.
+ * Only those that really have the type of the variable are kept.
+ */
+void InitiateSearchCB::get_deep_candidates(HandleSeq& handle_set,
+                                           const Handle& var,
+                                           const std::set<Type>& ptypes)
+{
+	HandleSeq found;
+	for (Type ptype : ptypes)
+		get_candidates(found, ptype);
+	for (const Handle& sig : _variables->_deep_typemap.at(var))
+		deep_candidates(found, sig);
+
+	UnorderedHandleSet seen;
+	for (const Handle& h : found)
+		if (_variables->is_type(var, h) and seen.insert(h).second)
+			handle_set.push_back(h);
+}
+
 /* ======================================================== */
 /**
  * Initiate a search by looping over all atoms of the allowed
@@ -673,6 +1089,7 @@ bool InitiateSearchCB::variable_search(PatternMatchEngine *pme)
 	// Find the rarest variable type;
 	size_t count = SIZE_MAX;
 	std::set<Type> ptypes;
+	Handle deep_var;
 
 	DO_LOG({LAZY_LOG_FINE << "_variables = " <<  _variables->to_string();})
 	_root = Handle::UNDEFINED;
@@ -681,31 +1098,38 @@ bool InitiateSearchCB::variable_search(PatternMatchEngine *pme)
 	{
 		DO_LOG({LAZY_LOG_FINE << "Examine variable " << var->toShortString();})
 
-#ifdef _IMPLEMENT_ME_LATER
-		// XXX TODO FIXME --- if there is a deep type in the mix, that
-		// will offer a far-superior place to start the search.
-		// Unfortunately, implementing this will require a bit more work,
-		// so we punt for now, as there are no users ....
+		// A deep type usually offers a far-superior place to start
+		// the search: the candidates can be found from the constants
+		// in the signature, instead of from the type index.
+		bool deep = false;
+		size_t num = 0;
 		auto dit = _variables->_deep_typemap.find(var);
 		if (_variables->_deep_typemap.end() != dit)
-			throw RuntimeException(TRACE_INFO, "Not implemented!");
-#endif
+		{
+			for (const Handle& sig : dit->second)
+				num = sat_add(num, deep_width(sig));
+			if (SIZE_MAX == num) continue;
+			deep = true;
+		}
 
+		static const std::set<Type> no_types;
 		auto tit = _variables->_simple_typemap.find(var);
-		if (_variables->_simple_typemap.end() == tit) continue;
-		const std::set<Type>& typeset = tit->second;
+		if (_variables->_simple_typemap.end() == tit and not deep) continue;
+		const std::set<Type>& typeset =
+			_variables->_simple_typemap.end() == tit ? no_types : tit->second;
 		DO_LOG({LAZY_LOG_FINE << "Type-restriction set size = "
 		              << typeset.size();})
 
 		// Calculate the total number of atoms of typeset
-		size_t num = 0;
 		for (Type t : typeset)
 			num += (size_t) _as->get_num_atoms_of_type(t);
 
 		DO_LOG({LAZY_LOG_FINE << var->toString() << "has "
 		              << num << " atoms in the atomspace";})
 
-		if (0 < num and num < count)
+		// The deep width is zero only if nothing can have the type;
+		// then there is nothing to search at all.
+		if ((deep or 0 < num) and num < count)
 		{
 			for (const Handle& cl : clauses)
 			{
@@ -722,6 +1146,7 @@ bool InitiateSearchCB::variable_search(PatternMatchEngine *pme)
 					_starter_term = cl;
 					count = num;
 					ptypes = typeset;
+					deep_var = deep ? var : Handle::UNDEFINED;
 					DO_LOG({LAZY_LOG_FINE << "New minimum count of " << count;})
 					break;
 				}
@@ -736,6 +1161,7 @@ bool InitiateSearchCB::variable_search(PatternMatchEngine *pme)
 						_starter_term = var;
 					count = num;
 					ptypes = typeset;
+					deep_var = deep ? var : Handle::UNDEFINED;
 					DO_LOG({LAZY_LOG_FINE << "New minimum count of "
 					              << count << " (nonroot)";})
 					break;
@@ -750,7 +1176,7 @@ bool InitiateSearchCB::variable_search(PatternMatchEngine *pme)
 
 		if (not _variables->_deep_typemap.empty())
 		{
-			logger().warn("Warning: Full deep-type support not implemented!");
+			logger().warn("Warning: Deep type offers no place to start!");
 		}
 		else
 		{
@@ -791,13 +1217,19 @@ bool InitiateSearchCB::variable_search(PatternMatchEngine *pme)
 	}
 
 	HandleSeq handle_set;
-	if (ptypes.empty())
-		_as->get_handles_by_type(handle_set, ATOM, true);
+	if (deep_var)
+		get_deep_candidates(handle_set, deep_var, ptypes);
+	else if (ptypes.empty())
+		get_candidates(handle_set, ATOM, true);
 	else
 		for (Type ptype : ptypes)
-			_as->get_handles_by_type(handle_set, ptype);
+			get_candidates(handle_set, ptype);
 
 	DO_LOG({LAZY_LOG_FINE << "Atomspace reported " << handle_set.size() << " atoms";})
+	note_start(pme, "variable", handle_set.size());
+
+	bool found;
+	if (parallel_search(pme, handle_set, found)) return found;
 
 #ifdef DEBUG
 	size_t i = 0, hsz = handle_set.size();
@@ -814,6 +1246,155 @@ bool InitiateSearchCB::variable_search(PatternMatchEngine *pme)
 	return false;
 }
 
+/* ======================================================== */
+/**
+ * Explore the candidate groundings in `handle_set` using several
+ * threads at once.  Each thread runs its own PatternMatchEngine,
+ * driving a worker callback obtained from clone_worker(); the
+ * workers pull candidates from a shared counter, so that a few
+ * expensive candidates do not leave the other threads idle. The
+ * calling thread acts as one of the workers.
+ *
+ * As soon as any worker's engine reports that the search is done
+ * (e.g. because the maximum number of results has been reached),
+ * all of the others stop at the next candidate.
+ *
+ * Returns false if the search was not run in parallel (too few
+ * candidates, parallelism not requested, or the callback cannot
+ * supply workers); the caller should then search sequentially.
+ * Otherwise, returns true, and `found` is set to the search result.
+ */
+bool InitiateSearchCB::parallel_search(PatternMatchEngine *pme,
+                                       const HandleSeq& handle_set,
+                                       bool& found)
+{
+	unsigned int nthreads = search_threads;
+	if (0 == nthreads) nthreads = default_search_threads;
+	if (nthreads <= 1 or handle_set.size() < parallel_min_candidates
+	    or pme->get_plan())
+		return false;
+
+	std::vector<PatternMatchCallback*> workers;
+	for (unsigned int i = 0; i < nthreads; i++)
+	{
+		PatternMatchCallback* w = clone_worker();
+		if (nullptr == w) break;
+
+		// The workers share the budget of the search that started them.
+		InitiateSearchCB* isw = dynamic_cast<InitiateSearchCB*>(w);
+		if (isw) isw->budget = pme->get_budget();
+		workers.push_back(w);
+	}
+	if (workers.size() <= 1)
+	{
+		for (PatternMatchCallback* w : workers)
+			release_worker(w);
+		return false;
+	}
+
+	DO_LOG({LAZY_LOG_FINE << "Parallel search over " << handle_set.size()
+	              << " candidates with " << workers.size() << " threads";})
+
+	size_t nworkers = workers.size();
+	size_t hsz = handle_set.size();
+	std::atomic<size_t> next(0);
+	std::atomic<bool> halt(false);
+	std::vector<std::exception_ptr> errors(nworkers);
+
+	// Each worker engine counts into a profile of its own; these are
+	// added up at the end.
+	PatternProfile* prof = pme->get_profile();
+	std::vector<PatternProfile> wprofs(prof ? nworkers : 0);
+
+	auto explore = [&](size_t wi)
+	{
+		PatternMatchCallback* wcb = workers[wi];
+		try
+		{
+			PatternMatchEngine wpme(*wcb);
+			if (prof)
+			{
+				wpme.set_profile(&wprofs[wi]);
+				InitiateSearchCB* isw = dynamic_cast<InitiateSearchCB*>(wcb);
+				if (isw) isw->profile = &wprofs[wi];
+			}
+			wpme.set_pattern(*_variables, *_pattern);
+			wcb->set_pattern(*_variables, *_pattern);
+			while (not halt)
+			{
+				size_t i = next.fetch_add(1);
+				if (hsz <= i) break;
+				if (wpme.explore_neighborhood(_root, _starter_term,
+				                              handle_set[i]))
+					halt = true;
+			}
+		}
+		catch (...)
+		{
+			errors[wi] = std::current_exception();
+			halt = true;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t wi = 1; wi < nworkers; wi++)
+		threads.push_back(std::thread(explore, wi));
+	explore(0);
+	for (std::thread& t : threads)
+		t.join();
+
+	for (PatternMatchCallback* w : workers)
+		release_worker(w);
+
+	for (const PatternProfile& wp : wprofs)
+		prof->merge(wp);
+
+	for (const std::exception_ptr& ep : errors)
+		if (ep) std::rethrow_exception(ep);
+
+	found = halt;
+	return true;
+}
+
+/* ======================================================== */
+/**
+ * Record how the search was started, when it is being profiled or
+ * explained. The `anchor` is the atom whose incoming set supplies
+ * the candidates, if there is one.
+ */
+void InitiateSearchCB::note_start(PatternMatchEngine* pme,
+                                  const char* method, size_t ncand,
+                                  const Handle& anchor)
+{
+	PatternProfile* prof = pme->get_profile();
+	PM_PROFILE(prof, {
+		prof->search_method = method;
+		prof->root_clause = _root;
+		prof->start_term = _starter_term;
+		prof->candidates += ncand; })
+
+	// When explaining, the engine declines every candidate; only the
+	// first choice of start is worked out in full.
+	SearchPlan* plan = pme->get_plan();
+	if (nullptr == plan) return;
+
+	plan->estimated_candidates += ncand;
+	if (not plan->search_method.empty()) return;
+
+	plan->search_method = method;
+	plan->root_clause = _root;
+	plan->start_term = _starter_term;
+	plan->anchor = anchor;
+	if (nullptr == _root) return;
+
+	TypeStats* stats = type_stats;
+	if (nullptr == stats) stats = TypeStats::attached(_as);
+	plan->steps = pme->plan_clauses(_root, stats);
+	for (SearchPlan::Step& st : plan->steps)
+		if (not st.evaluatable)
+			st.type_count = _as->get_num_atoms_of_type(st.clause->getType());
+}
+
 /* ======================================================== */
 /**
  * No search -- no variables, only constant, possibly evaluatable
@@ -835,6 +1416,7 @@ bool InitiateSearchCB::no_search(PatternMatchEngine *pme)
 	}
 
 	// Evaluate all evaluatable clauses
+	note_start(pme, "no-search", 0);
 	return pme->explore_constant_evaluatables(_pattern->mandatory);
 }
 
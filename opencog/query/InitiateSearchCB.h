@@ -28,8 +28,10 @@
 #include <opencog/atoms/base/types.h>
 #include <opencog/atoms/base/Quotation.h>
 #include <opencog/atoms/pattern/PatternLink.h>
+#include <opencog/query/NumberIndex.h>
 #include <opencog/query/PatternMatchCallback.h>
 #include <opencog/query/PatternMatchEngine.h>
+#include <opencog/query/TypeStats.h>
 
 namespace opencog {
 
@@ -55,6 +57,51 @@ public:
 	virtual void set_pattern(const Variables&, const Pattern&);
 	virtual bool initiate_search(PatternMatchEngine *);
 
+	/**
+	 * Number of threads used to explore the candidates of a
+	 * link-type or variable search. Zero means "use the global
+	 * default"; one means "search sequentially".  Parallel search
+	 * is used only if the callback can supply workers (see
+	 * PatternMatchCallback::clone_worker()).
+	 */
+	unsigned int search_threads;
+	static unsigned int default_search_threads;
+
+	// Searches with fewer candidates than this are not worth the
+	// overhead of starting threads; they are always sequential.
+	static size_t parallel_min_candidates;
+
+	/**
+	 * If set, statistics about the search are collected here; see
+	 * PatternProfile.h.  Null by default.
+	 */
+	PatternProfile* profile;
+	virtual PatternProfile* get_profile(void) { return profile; }
+
+	/**
+	 * If set, the search stops early once any of the limits in the
+	 * budget is used up; see QueryBudget.h.  Null by default.
+	 */
+	QueryBudget* budget;
+	virtual QueryBudget* get_budget(void) { return budget; }
+
+	/**
+	 * If set, a variable typed to NumberNode, and bounded by
+	 * GreaterThanLink clauses, may be used to start the search:
+	 * the candidates are then the numbers within the bounds. By
+	 * default, the index attached to the atomspace, if any (see
+	 * NumberIndex::attach()).
+	 */
+	NumberIndex* number_index;
+
+	/**
+	 * If set, used to estimate the cost of the joins when a search
+	 * is explained; the search itself does not use it. If not set,
+	 * the statistics attached to the atomspace, if any, are looked
+	 * up when the explanation is made (see TypeStats::attach()).
+	 */
+	TypeStats* type_stats;
+
 protected:
 
 	ClassServer& _classserver;
@@ -87,11 +134,32 @@ protected:
 	virtual void find_rarest(const Handle&, Handle&, size_t&,
 	                         Quotation quotation=Quotation());
 
+	// Append to the sequence the atoms of the given type (and of its
+	// subtypes, if asked for) that a link-type or variable search
+	// may start at. By default, that is all of them, in the atomspace.
+	virtual void get_candidates(HandleSeq&, Type, bool subclass = false);
+
+	// Candidates for a variable with a deep type (a SignatureLink),
+	// found from the constants in the signature.
+	size_t deep_width(const Handle&);
+	size_t deep_link_width(const Handle&, Arity&);
+	void deep_candidates(HandleSeq&, const Handle&);
+	void get_deep_candidates(HandleSeq&, const Handle&,
+	                         const std::set<Type>&);
+
+	IncomingSet get_start_incoming(const Handle&, const Handle&);
+
 	bool _search_fail;
 	virtual bool neighbor_search(PatternMatchEngine *);
 	virtual bool link_type_search(PatternMatchEngine *);
 	virtual bool variable_search(PatternMatchEngine *);
 	virtual bool no_search(PatternMatchEngine *);
+	virtual bool range_search(PatternMatchEngine *);
+	bool number_bounds(const Handle&, NumberIndex::Bounds&);
+	size_t neighbor_width(void);
+	bool parallel_search(PatternMatchEngine *, const HandleSeq&, bool&);
+	void note_start(PatternMatchEngine *, const char*, size_t,
+	                const Handle& = Handle::UNDEFINED);
 
 #ifdef CACHED_IMPLICATOR
 	virtual void ready(AtomSpace*);
@@ -0,0 +1,204 @@
+/*
+ * NumberIndex.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include <boost/bind.hpp>
+
+#include <opencog/atoms/NumberNode.h>
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "AttachedRegistry.h"
+#include "NumberIndex.h"
+
+using namespace opencog;
+
+NumberIndex::Bounds::Bounds(void) :
+	lo(-std::numeric_limits<double>::infinity()),
+	hi(std::numeric_limits<double>::infinity()),
+	lo_open(false), hi_open(false)
+{
+}
+
+void NumberIndex::Bounds::above(double v, bool open)
+{
+	if (v > lo or (v == lo and open))
+	{
+		lo = v;
+		lo_open = open;
+	}
+}
+
+void NumberIndex::Bounds::below(double v, bool open)
+{
+	if (v < hi or (v == hi and open))
+	{
+		hi = v;
+		hi_open = open;
+	}
+}
+
+bool NumberIndex::Bounds::bounded(void) const
+{
+	return std::isfinite(lo) or std::isfinite(hi);
+}
+
+bool NumberIndex::Bounds::contains(double v) const
+{
+	if (v < lo or (v == lo and lo_open)) return false;
+	if (v > hi or (v == hi and hi_open)) return false;
+	return true;
+}
+
+/* ======================================================== */
+
+/// The value of a NumberNode; NaN for anything else. NaN is never
+/// indexed, as it has no place in the order.
+static double value_of(const Handle& h)
+{
+	NumberNodePtr nn(NumberNodeCast(h));
+	if (nullptr == nn) return std::numeric_limits<double>::quiet_NaN();
+	return nn->get_value();
+}
+
+NumberIndex::NumberIndex(AtomSpace* as) :
+	_as(as)
+{
+	// Connect before the scan, so that no atom is missed; an atom
+	// seen twice is indexed once.  The scan takes in the parent
+	// atomspaces, so their signals are needed as well.
+	for (AtomSpace* env = as; env; env = env->get_environ())
+	{
+		_connections.push_back(env->addAtomSignal(
+			boost::bind(&NumberIndex::atom_added, this, _1)));
+		_connections.push_back(env->removeAtomSignal(
+			boost::bind(&NumberIndex::atom_removed, this, _1)));
+	}
+
+	HandleSeq numbers;
+	as->get_handles_by_type(numbers, NUMBER_NODE);
+	for (const Handle& h : numbers)
+		atom_added(h);
+}
+
+NumberIndex::~NumberIndex()
+{
+	for (boost::signals2::connection& c : _connections)
+		c.disconnect();
+}
+
+/* ======================================================== */
+
+static AttachedRegistry<NumberIndex> _attached;
+
+NumberIndex* NumberIndex::attach(AtomSpace* as)
+{
+	return _attached.attach(as);
+}
+
+NumberIndex* NumberIndex::attached(AtomSpace* as)
+{
+	return _attached.attached(as);
+}
+
+void NumberIndex::atom_added(const Handle& h)
+{
+	if (NUMBER_NODE != h->getType()) return;
+	double v = value_of(h);
+	if (std::isnan(v)) return;
+
+	std::lock_guard<std::mutex> lck(_mtx);
+	auto eq = _values.equal_range(v);
+	for (auto it = eq.first; it != eq.second; it++)
+		if (it->second == h) return;
+	_values.insert(eq.second, {v, h});
+}
+
+void NumberIndex::atom_removed(const AtomPtr& atom)
+{
+	if (NUMBER_NODE != atom->getType()) return;
+	Handle h(atom->getHandle());
+	double v = value_of(h);
+	if (std::isnan(v)) return;
+
+	std::lock_guard<std::mutex> lck(_mtx);
+	auto eq = _values.equal_range(v);
+	for (auto it = eq.first; it != eq.second; it++)
+	{
+		if (it->second != h) continue;
+		_values.erase(it);
+		return;
+	}
+}
+
+/* ======================================================== */
+
+/// The entries in the interval are those in [begin, end).
+void NumberIndex::find(const Bounds& b, Iter& begin, Iter& end) const
+{
+	begin = b.lo_open ? _values.upper_bound(b.lo) : _values.lower_bound(b.lo);
+	end = b.hi_open ? _values.lower_bound(b.hi) : _values.upper_bound(b.hi);
+
+	// An empty interval, e.g. (3, 3).
+	if (b.hi < b.lo or (b.hi == b.lo and (b.lo_open or b.hi_open)))
+		end = begin;
+}
+
+HandleSeq NumberIndex::range(const Bounds& b)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	Iter begin, end;
+	find(b, begin, end);
+
+	HandleSeq found;
+	for (Iter it = begin; it != end; it++)
+		found.push_back(it->second);
+	return found;
+}
+
+HandleSeq NumberIndex::range(double lo, double hi)
+{
+	Bounds b;
+	b.above(lo, false);
+	b.below(hi, false);
+	return range(b);
+}
+
+size_t NumberIndex::count(const Bounds& b, size_t cap)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	Iter begin, end;
+	find(b, begin, end);
+
+	size_t n = 0;
+	for (Iter it = begin; it != end and n < cap; it++) n++;
+	return n;
+}
+
+size_t NumberIndex::size(void)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	return _values.size();
+}
+
+/* ===================== END OF FILE ===================== */
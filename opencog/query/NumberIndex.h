@@ -0,0 +1,122 @@
+/*
+ * NumberIndex.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_NUMBER_INDEX_H
+#define _OPENCOG_NUMBER_INDEX_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <boost/signals2.hpp>
+
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog {
+
+class AtomSpace;
+
+/**
+ * class NumberIndex -- the NumberNodes of an atomspace, ordered by
+ * value.
+ *
+ * Without it, the only way to find the numbers in some range is to
+ * look at every NumberNode in the atomspace. With it, the numbers in
+ * a range are found in time proportional to their count. The pattern
+ * matcher uses it, if given one (see InitiateSearchCB::number_index),
+ * to start the search at the numbers that a variable typed to
+ * NumberNode can take, when GreaterThanLink clauses bound it.
+ *
+ * The index is kept up to date through the atom-added and atom-removed
+ * signals of the atomspace, and of its parents, whose atoms the
+ * atomspace also holds.
+ *
+ * An index attached to an atomspace with attach() is used by every
+ * query on that atomspace: bindlink, cog-bind, the rule engine, and
+ * so on. Attached indexes live until their atomspace is deleted.
+ */
+class NumberIndex
+{
+	public:
+		/// An interval of values. Each end may be open or closed;
+		/// by default, the interval is unbounded.
+		struct Bounds
+		{
+			Bounds(void);
+			double lo, hi;
+			bool lo_open, hi_open;
+
+			/// Narrow the interval to the values above (or below) v.
+			void above(double v, bool open);
+			void below(double v, bool open);
+
+			bool bounded(void) const;
+			bool contains(double) const;
+		};
+
+		NumberIndex(AtomSpace*);
+		~NumberIndex();
+
+		/// The NumberNodes with values in the interval, smallest first.
+		HandleSeq range(const Bounds&);
+
+		/// Same as above, for the closed interval [lo, hi].
+		HandleSeq range(double lo, double hi);
+
+		/// The number of NumberNodes with values in the interval, or
+		/// `cap`, if there are more; only that many are counted.
+		size_t count(const Bounds&, size_t cap = SIZE_MAX);
+
+		/// Number of NumberNodes indexed.
+		size_t size(void);
+
+		AtomSpace* get_atomspace(void) const { return _as; }
+
+		/// Attach an index to the atomspace, building it if it has
+		/// none yet, and return it.
+		static NumberIndex* attach(AtomSpace*);
+
+		/// The index attached to the atomspace, or null if none.
+		static NumberIndex* attached(AtomSpace*);
+
+		/// False once the atomspace has been deleted; the signals
+		/// disconnect all of their slots when they go away.
+		bool alive(void) const { return _connections.front().connected(); }
+
+	private:
+		AtomSpace* _as;
+		std::vector<boost::signals2::connection> _connections;
+
+		std::mutex _mtx;
+		std::multimap<double, Handle> _values;
+
+		typedef std::multimap<double, Handle>::const_iterator Iter;
+		void find(const Bounds&, Iter&, Iter&) const;
+
+		void atom_added(const Handle&);
+		void atom_removed(const AtomPtr&);
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_NUMBER_INDEX_H
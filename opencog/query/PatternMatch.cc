@@ -21,8 +21,12 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+#include <unordered_map>
+
 #include <opencog/util/Logger.h>
 
+#include <opencog/atoms/NumberNode.h>
 #include <opencog/atoms/pattern/BindLink.h>
 #include <opencog/atoms/pattern/PatternLink.h>
 
@@ -32,6 +36,9 @@
 #include "PatternMatch.h"
 #include "PatternMatchEngine.h"
 #include "PatternMatchCallback.h"
+#include "PatternProfile.h"
+#include "QueryBudget.h"
+#include "SearchPlan.h"
 #include "DefaultPatternMatchCB.h"
 
 using namespace opencog;
@@ -89,6 +96,10 @@ class PMCGroundings : public PatternMatchCallback
 		IncomingSet get_incoming_set(const Handle& h) {
 			return _cb.get_incoming_set(h);
 		}
+		IncomingSet get_incoming_by_position(const Handle& h,
+		                                     Type t, Arity pos) {
+			return _cb.get_incoming_by_position(h, t, pos);
+		}
 		void push(void) { _cb.push(); }
 		void pop(void) { _cb.pop(); }
 		void set_pattern(const Variables& vars,
@@ -107,6 +118,16 @@ class PMCGroundings : public PatternMatchCallback
 			return _cb.search_finished(done);
 		}
 
+		PatternProfile* get_profile(void)
+		{
+			return _cb.get_profile();
+		}
+
+		QueryBudget* get_budget(void)
+		{
+			return _cb.get_budget();
+		}
+
 		// This one we don't pass through. Instead, we collect the
 		// groundings.
 		bool grounding(const HandleMap &var_soln,
@@ -152,6 +173,12 @@ bool PatternMatch::recursive_virtual(PatternMatchCallback& cb,
 	// many combinatoric possibilities in the var_gnds and term_gnds
 	// maps. Submit this grounding map to the virtual links, and see
 	// what they've got to say about it.
+	//
+	// The product of the components can be huge; a used-up budget
+	// halts it, just as the callback would.
+	QueryBudget* budget = cb.get_budget();
+	if (budget and budget->exhausted()) return true;
+
 	if (0 == comp_var_gnds.size())
 	{
 #ifdef DEBUG
@@ -164,6 +191,8 @@ bool PatternMatch::recursive_virtual(PatternMatchCallback& cb,
 		}
 #endif
 
+		PatternProfile* prof = cb.get_profile();
+
 		// Note, FYI, that if there are no virtual clauses at all,
 		// then this loop falls straight-through, and the grounding
 		// is reported as a match to the callback.  That is, the
@@ -191,6 +220,8 @@ bool PatternMatch::recursive_virtual(PatternMatchCallback& cb,
 			// in the Arg atoms. So, we ground the args, and pass that
 			// to the callback.
 
+			PM_PROFILE(prof, prof->virtual_evals++)
+			ProfileTimer vtime(prof ? &prof->virtual_seconds : nullptr);
 			bool match = cb.evaluate_sentence(virt, var_gnds);
 
 			if (not match) return false;
@@ -198,7 +229,10 @@ bool PatternMatch::recursive_virtual(PatternMatchCallback& cb,
 
 		// Yay! We found one! We now have a fully and completely grounded
 		// pattern! See what the callback thinks of it.
-		return cb.grounding(var_gnds, term_gnds);
+		PM_PROFILE(prof, prof->groundings++)
+		bool halt = cb.grounding(var_gnds, term_gnds);
+		if (budget and budget->charge_grounding()) return true;
+		return halt;
 	}
 #ifdef DEBUG
 	LAZY_LOG_FINE << "Component recursion: num comp=" << comp_var_gnds.size();
@@ -241,6 +275,190 @@ bool PatternMatch::recursive_virtual(PatternMatchCallback& cb,
 	return false;
 }
 
+/* ================================================================= */
+/*
+ * Joins of components.
+ *
+ * Most virtual clauses that tie components together compare one
+ * variable of one component to one variable of another, e.g.
+ *
+ *   GreaterThanLink
+ *       VariableNode "$x"    ; grounded in one component
+ *       VariableNode "$y"    ; grounded in another
+ *
+ * The nested loop in recursive_virtual() tries every combination of
+ * the groundings of the two components, although only a few of them
+ * will pass. For IdenticalLink and EqualLink, the groundings that
+ * pass are found with a hash table; for GreaterThanLink, by sorting
+ * one side by value. The two components are then replaced by the one
+ * joined component, holding just the combinations that can pass.
+ *
+ * This only drops combinations that the virtual clause would reject;
+ * the combinations that are kept still go through recursive_virtual(),
+ * and the virtual clauses and the callback still have the final say.
+ * If a grounding is not something the join understands (e.g. a link,
+ * which the clause might execute before comparing), the join is not
+ * done, and the nested loop handles that clause.
+ */
+
+typedef std::vector<std::pair<size_t, size_t>> JoinPairs;
+
+/// Which component grounds the variable `var`? Returns -1 if none
+/// does, or if some grounding of that component does not include it.
+static int component_of(const Handle& var,
+                        const std::vector<HandleMapSeq>& comp_var_gnds)
+{
+	for (size_t c = 0; c < comp_var_gnds.size(); c++)
+	{
+		const HandleMapSeq& gnds = comp_var_gnds[c];
+		if (gnds.empty() or 0 == gnds[0].count(var)) continue;
+		for (const HandleMap& g : gnds)
+			if (0 == g.count(var)) return -1;
+		return c;
+	}
+	return -1;
+}
+
+/// Nodes are compared as they are; anything else may be executed
+/// by the virtual clause before it is compared.
+static bool is_plain(const Handle& h)
+{
+	return h->isNode() and DEFINED_SCHEMA_NODE != h->getType();
+}
+
+/// Pairs of groundings in which `va` and `vb` are grounded by the
+/// same atom.
+static bool hash_join(const Handle& va, const HandleMapSeq& ga,
+                      const Handle& vb, const HandleMapSeq& gb,
+                      JoinPairs& pairs)
+{
+	std::unordered_map<Handle, std::vector<size_t>> table;
+	for (size_t j = 0; j < gb.size(); j++)
+	{
+		const Handle& h = gb[j].at(vb);
+		if (not is_plain(h)) return false;
+		table[h].push_back(j);
+	}
+
+	for (size_t i = 0; i < ga.size(); i++)
+	{
+		const Handle& h = ga[i].at(va);
+		if (not is_plain(h)) return false;
+		auto bucket = table.find(h);
+		if (table.end() == bucket) continue;
+		for (size_t j : bucket->second)
+			pairs.push_back({i, j});
+	}
+	return true;
+}
+
+/// Pairs of groundings in which `va` is grounded by a greater number
+/// than `vb` is.
+static bool merge_join(const Handle& va, const HandleMapSeq& ga,
+                       const Handle& vb, const HandleMapSeq& gb,
+                       JoinPairs& pairs)
+{
+	std::vector<std::pair<double, size_t>> bvals;
+	bvals.reserve(gb.size());
+	for (size_t j = 0; j < gb.size(); j++)
+	{
+		NumberNodePtr nn(NumberNodeCast(gb[j].at(vb)));
+		if (nullptr == nn) return false;
+		bvals.push_back({nn->get_value(), j});
+	}
+	std::sort(bvals.begin(), bvals.end());
+
+	for (size_t i = 0; i < ga.size(); i++)
+	{
+		NumberNodePtr nn(NumberNodeCast(ga[i].at(va)));
+		if (nullptr == nn) return false;
+
+		// All of the smaller values come before the first one that
+		// is not smaller.
+		auto end = std::lower_bound(bvals.begin(), bvals.end(),
+			std::make_pair(nn->get_value(), (size_t) 0));
+		for (auto it = bvals.begin(); it != end; it++)
+			pairs.push_back({i, it->second});
+	}
+	return true;
+}
+
+/**
+ * Join components pairwise on the virtual clauses that compare one
+ * variable of each; see the notes above. The components that are left
+ * are those that no such clause ties together; recursive_virtual()
+ * takes their product.
+ */
+void PatternMatch::join_components(PatternMatchCallback& cb,
+            const HandleSeq& virtuals,
+            std::vector<HandleMapSeq>& comp_var_gnds,
+            std::vector<HandleMapSeq>& comp_term_gnds)
+{
+	QueryBudget* budget = cb.get_budget();
+
+	bool joined = true;
+	while (joined and 1 < comp_var_gnds.size())
+	{
+		joined = false;
+		for (const Handle& virt : virtuals)
+		{
+			if (budget and budget->exhausted()) return;
+
+			Type vt = virt->getType();
+			if (IDENTICAL_LINK != vt and EQUAL_LINK != vt and
+			    GREATER_THAN_LINK != vt)
+				continue;
+			if (2 != virt->getArity()) continue;
+
+			const Handle& va = virt->getOutgoingAtom(0);
+			const Handle& vb = virt->getOutgoingAtom(1);
+			int ia = component_of(va, comp_var_gnds);
+			int ib = component_of(vb, comp_var_gnds);
+			if (ia < 0 or ib < 0 or ia == ib) continue;
+
+			const HandleMapSeq& ga = comp_var_gnds[ia];
+			const HandleMapSeq& gb = comp_var_gnds[ib];
+			JoinPairs pairs;
+			bool ok = (GREATER_THAN_LINK == vt) ?
+				merge_join(va, ga, vb, gb, pairs) :
+				hash_join(va, ga, vb, gb, pairs);
+			if (not ok) continue;
+
+#ifdef DEBUG
+			LAZY_LOG_FINE << "Joined components of sizes "
+			              << ga.size() << " and "
+			              << gb.size() << " into "
+			              << pairs.size() << " groundings, on:\n"
+			              << virt->toShortString();
+#endif
+
+			HandleMapSeq jvg, jtg;
+			jvg.reserve(pairs.size());
+			jtg.reserve(pairs.size());
+			for (const auto& pr : pairs)
+			{
+				HandleMap vg(comp_var_gnds[ia][pr.first]);
+				HandleMap tg(comp_term_gnds[ia][pr.first]);
+				vg.insert(comp_var_gnds[ib][pr.second].begin(),
+				          comp_var_gnds[ib][pr.second].end());
+				tg.insert(comp_term_gnds[ib][pr.second].begin(),
+				          comp_term_gnds[ib][pr.second].end());
+				jvg.push_back(vg);
+				jtg.push_back(tg);
+			}
+
+			comp_var_gnds[ia].swap(jvg);
+			comp_term_gnds[ia].swap(jtg);
+			comp_var_gnds.erase(comp_var_gnds.begin() + ib);
+			comp_term_gnds.erase(comp_term_gnds.begin() + ib);
+
+			// The component numbers have changed; start over.
+			joined = true;
+			break;
+		}
+	}
+}
+
 /* ================================================================= */
 /**
  * Ground (solve) a pattern; perform unification. That is, find one
@@ -396,6 +614,10 @@ bool PatternLink::satisfy(PatternMatchCallback& pmcb) const
 	std::vector<HandleMapSeq> comp_term_gnds;
 	std::vector<HandleMapSeq> comp_var_gnds;
 
+	// The component searches report their groundings to PMCGroundings,
+	// below; these are not (yet) groundings of the whole pattern.
+	PatternProfile* prof = pmcb.get_profile();
+
 	for (size_t i = 0; i < _num_comps; i++)
 	{
 #ifdef DEBUG
@@ -410,8 +632,14 @@ bool PatternLink::satisfy(PatternMatchCallback& pmcb) const
 			is_pure_optional = true;
 
 		// Pass through the callbacks, collect up answers.
+		// The engine counts them as it reports them; move that count
+		// over, rather than subtracting a count taken elsewhere.
+		size_t reported = prof ? prof->groundings : 0;
 		PMCGroundings gcb(pmcb);
 		clp->satisfy(gcb);
+		PM_PROFILE(prof, {
+			prof->component_groundings += prof->groundings - reported;
+			prof->groundings = reported; })
 
 		// Special handling for disconnected pure optionals -- Returns false to
 		// end the search if this disconnected pure optional is found
@@ -449,11 +677,82 @@ bool PatternLink::satisfy(PatternMatchCallback& pmcb) const
 	HandleMap empty_pg;
 	HandleSeq optionals; // currently ignored
 	pmcb.set_pattern(_varlist, _pat);
+	PatternMatch::join_components(pmcb, _virtual,
+	                              comp_var_gnds, comp_term_gnds);
 	return PatternMatch::recursive_virtual(pmcb, _virtual, optionals,
 	                                       empty_vg, empty_pg,
 	                                       comp_var_gnds, comp_term_gnds);
 }
 
+/**
+ * Search for groundings, starting at the clause `clause`, trying each
+ * of `groundings` for it, in turn, instead of letting the callback
+ * choose where to start. This is for callers that already know the
+ * groundings of one of the clauses; e.g. a batch of queries that share
+ * that clause (see batch_query()). The groundings are checked against
+ * the clause as usual; they do not have to be exact.
+ *
+ * The pattern must have a single component.
+ */
+bool PatternLink::satisfy_from(PatternMatchCallback& pmcb,
+                               const Handle& clause,
+                               const HandleSeq& groundings) const
+{
+	if (1 < _num_comps)
+		throw InvalidParamException(TRACE_INFO,
+			"Cannot start a search with several components at one clause!");
+
+	PatternMatchEngine pme(pmcb);
+	pme.set_pattern(_varlist, _pat);
+	pmcb.set_pattern(_varlist, _pat);
+
+	QueryBudget* qb = pme.get_budget();
+	if (qb) qb->begin();
+
+	bool found = false;
+	for (const Handle& gnd : groundings)
+	{
+		found = pme.explore_neighborhood(clause, clause, gnd);
+		if (found) break;
+	}
+	return pmcb.search_finished(found);
+}
+
+/**
+ * Explain how satisfy() would go about grounding this pattern, with
+ * the given callback, without actually grounding anything. The
+ * callback picks the starting point just as it would for a real
+ * search; the engine then declines every candidate that it is
+ * offered. Evaluatable clauses are not evaluated.
+ *
+ * For patterns with several components, each component is explained
+ * separately; the virtual clauses that join them are listed as well.
+ */
+SearchPlan PatternLink::explain(PatternMatchCallback& pmcb) const
+{
+	SearchPlan plan;
+	if (_num_comps <= 1)
+	{
+		PatternMatchEngine pme(pmcb);
+		pme.set_plan(&plan);
+		pme.set_pattern(_varlist, _pat);
+		pmcb.set_pattern(_varlist, _pat);
+		pmcb.initiate_search(&pme);
+		return plan;
+	}
+
+	plan.search_method = "components";
+	for (size_t i = 0; i < _num_comps; i++)
+	{
+		PatternLinkPtr clp(PatternLinkCast(_component_patterns.at(i)));
+		plan.components.push_back(clp->explain(pmcb));
+		plan.estimated_candidates +=
+			plan.components.back().estimated_candidates;
+	}
+	plan.virtuals = _virtual;
+	return plan;
+}
+
 // For gdb, see
 // http://wiki.opencog.org/w/Development_standards#Print_OpenCog_Objects
 std::string oc_to_string(const Pattern& pattern)
@@ -46,6 +46,11 @@ class PatternMatch
 		            const HandleMap& term_gnds,
 		            std::vector<HandleMapSeq> comp_var_gnds,
 		            std::vector<HandleMapSeq> comp_term_gnds);
+
+		static void join_components(PatternMatchCallback& cb,
+		            const HandleSeq& virtuals,
+		            std::vector<HandleMapSeq>& comp_var_gnds,
+		            std::vector<HandleMapSeq>& comp_term_gnds);
 };
 
 } // namespace opencog
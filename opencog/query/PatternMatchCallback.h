@@ -34,6 +34,8 @@
 
 namespace opencog {
 class PatternMatchEngine;
+struct PatternProfile;
+struct QueryBudget;
 
 /**
  * Callback interface, used to implement specifics of hypergraph
@@ -285,6 +287,22 @@ class PatternMatchCallback
 			return h->getIncomingSet();
 		}
 
+		/**
+		 * Called instead of get_incoming_set() when the term being
+		 * grounded is an ordered link of type `t`, holding the
+		 * already-grounded `h` at position `pos`.  Only the links of
+		 * that type, with `h` at that position, can then be groundings
+		 * (if link_match() accepts links of the pattern type only);
+		 * a callback may return just those.  Returning more is never
+		 * wrong, as the engine checks every link that it is given.
+		 * By default, this returns get_incoming_set(h).
+		 */
+		virtual IncomingSet get_incoming_by_position(const Handle& h,
+		                                             Type t, Arity pos)
+		{
+			return get_incoming_set(h);
+		}
+
 		/**
 		 * Called after a top-level clause (tree) has been fully
 		 * grounded. This gives the callee the opportunity to save
@@ -335,6 +353,40 @@ class PatternMatchCallback
 		 */
 		virtual void set_pattern(const Variables& vars,
 		                         const Pattern& pat) = 0;
+
+		/**
+		 * Called to obtain a worker callback for a parallel search.
+		 * The search initiator may partition the candidate groundings
+		 * across several threads; each thread runs its own engine,
+		 * driving its own worker callback.  The worker must report
+		 * its groundings back to this callback in a thread-safe way.
+		 *
+		 * Return nullptr (the default) if this callback cannot be
+		 * run in parallel; the search then proceeds sequentially.
+		 */
+		virtual PatternMatchCallback* clone_worker(void) { return nullptr; }
+
+		/**
+		 * Called after a worker obtained from `clone_worker()` has
+		 * finished, on the thread that started the search. Any
+		 * remaining worker state should be folded back into this
+		 * callback; the worker is then deleted.
+		 */
+		virtual void release_worker(PatternMatchCallback* worker)
+		{ delete worker; }
+
+		/**
+		 * Return a profile into which the engine should collect
+		 * statistics about the search (see PatternProfile.h), or
+		 * nullptr (the default), to not collect any.
+		 */
+		virtual PatternProfile* get_profile(void) { return nullptr; }
+
+		/**
+		 * Return the limits on the work the search may do (see
+		 * QueryBudget.h), or nullptr (the default) for no limits.
+		 */
+		virtual QueryBudget* get_budget(void) { return nullptr; }
 };
 
 } // namespace opencog
@@ -21,6 +21,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+#include <functional>
+
 #include <opencog/util/algorithm.h>
 #include <opencog/util/oc_assert.h>
 #include <opencog/util/Logger.h>
@@ -31,6 +34,8 @@
 #include <opencog/atomspace/AtomSpace.h>
 
 #include "PatternMatchEngine.h"
+#include "PatternProfile.h"
+#include "QueryBudget.h"
 
 
 using namespace opencog;
@@ -131,7 +136,7 @@ bool PatternMatchEngine::variable_compare(const Handle& hp,
 	DO_LOG({LAZY_LOG_FINE << "Found grounding of variable:";})
 	logmsg("$$ variable:", hp);
 	logmsg("$$ ground term:", hg);
-	if (hp->getType() != GLOB_NODE) var_grounding[hp] = hg;
+	if (hp->getType() != GLOB_NODE) ground(var_grounding, hp, hg);
 	return true;
 }
 
@@ -146,7 +151,7 @@ bool PatternMatchEngine::variable_compare(const Handle& hp,
 bool PatternMatchEngine::self_compare(const PatternTermPtr& ptm)
 {
 	const Handle& hp = ptm->getHandle();
-	if (not ptm->isQuoted()) var_grounding[hp] = hp;
+	if (not ptm->isQuoted()) ground(var_grounding, hp, hp);
 
 	logmsg("Compare atom to itself:", hp);
 	return true;
@@ -165,7 +170,7 @@ bool PatternMatchEngine::node_compare(const Handle& hp,
 		DO_LOG({LAZY_LOG_FINE << "Found matching nodes";})
 		logmsg("# pattern:", hp);
 		logmsg("# match:", hg);
-		if (hp != hg) var_grounding[hp] = hg;
+		if (hp != hg) ground(var_grounding, hp, hg);
 	}
 	return match;
 }
@@ -227,151 +232,224 @@ bool PatternMatchEngine::ordered_compare(const PatternTermPtr& ptm,
 		// If we are here, then the pattern contains globs. A glob can
 		// match one or more atoms in a row. Thus, we have a more
 		// complicated search ...
-		for (size_t ip=0, jg=0; ip<osp_size or jg<osg_size; ip++, jg++)
-		{
-			if (ip == osp_size) ip --;
+		match = glob_compare(ptm, hg);
+	}
 
-			bool grd_end = false;
-			if (jg == osg_size)
-			{
-				grd_end = true;
-				jg --;
-			}
+	depth --;
+	DO_LOG({LAZY_LOG_FINE << "tree_comp down link match=" << match;})
 
-			bool tc = false;
-			const Handle& ohp(osp[ip]->getHandle());
-			Type ptype = ohp->getType();
-			if (GLOB_NODE == ptype)
-			{
-				// GlobNodes cannot match themselves -- no self-grounding
-				// is allowed. TODO -- maybe this check should be moved
-				// to the clause_match() callback?
-				if (ohp == osg[jg]) return false;
-
-				HandleSeq glob_seq;
-				PatternTermPtr glob(osp[ip]);
-				// Globs at the end are handled differently than globs
-				// which are followed by other stuff. So, is there
-				// anything after the glob?
-				PatternTermPtr post_glob;
-				bool have_post = false;
-				if (ip+1 < osp_size)
-				{
-					have_post = true;
-					post_glob = osp[ip+1];
-				}
+	const Handle &hp = ptm->getHandle();
+	if (not match)
+	{
+		_pmc.post_link_mismatch(hp, hg);
+		return false;
+	}
 
-				if (_varlist->is_lower_bound(ohp, 0))
-				{
-					// If we are here, that means the lower bound of the
-					// interval is zero, so the glob can be grounded
-					// to nothing.
+	// If we've found a grounding, lets see if the
+	// post-match callback likes this grounding.
+	match = _pmc.post_link_match(hp, hg);
+	if (not match) return false;
 
-					// Just in case if the upper bound is zero...
-					if (not _varlist->is_upper_bound(ohp, 1))
-					{
-						jg --;
-						continue;
-					}
+	// If we've found a grounding, record it.
+	if (hp != hg) ground(var_grounding, hp, hg);
 
-					// If the post_glob matches with the current candidate,
-					// we are done.
-					if (tree_compare(glob, osg[jg], CALL_GLOB) and
-					    have_post and
-					    tree_compare(post_glob, osg[jg], CALL_GLOB))
-					{
-						jg --;
-						continue;
-					}
+	return true;
+}
 
-					// Since the glob has a lower bound of zero, if we
-					// already have gone through all the candidates at
-					// this point, we are done.
-					if (grd_end) continue;
-				}
+/* ======================================================== */
 
-				// If we are here, the glob we are looking at has to be
-				// grounded to at least one atom.
+/// Work out, for the link `h` holding globs, how many atoms each
+/// position of its outgoing set can match: exactly one for anything
+/// that is not a glob, and the interval of the glob otherwise. Add
+/// these up over each tail of the outgoing set, so that the search
+/// can tell at once if what is left of the grounding is too short,
+/// or too long, for what is left of the pattern.
+void PatternMatchEngine::add_glob_bounds(const Handle& h)
+{
+	const HandleSeq& oset = h->getOutgoingSet();
+	size_t osz = oset.size();
+
+	GlobBounds gb;
+	gb.min_len.resize(osz, 1);
+	gb.max_len.resize(osz, 1);
+	gb.min_rest.resize(osz+1, 0);
+	gb.max_rest.resize(osz+1, 0);
+	for (size_t i = 0; i < osz; i++)
+	{
+		if (GLOB_NODE != oset[i]->getType()) continue;
+		std::pair<size_t, size_t> ival(_varlist->get_interval(oset[i]));
+		gb.min_len[i] = ival.first;
+		gb.max_len[i] = ival.second;
+	}
+	for (size_t i = osz; 0 < i; i--)
+	{
+		gb.min_rest[i-1] = gb.min_rest[i] + gb.min_len[i-1];
+		gb.max_rest[i-1] = (SIZE_MAX - gb.max_rest[i] < gb.max_len[i-1]) ?
+			SIZE_MAX : gb.max_rest[i] + gb.max_len[i-1];
+	}
 
-				// We need to ground the glob but we have gone through
-				// everything in osg already, then it's not a match.
-				if (grd_end)
-				{
-					match = false;
-					break;
-				}
+	// A failure to match the tail of the pattern, starting at some
+	// place in the grounding, can be remembered only if the tail does
+	// not depend on how the head was grounded; that is, if no variable
+	// shows up in more than one position.
+	gb.memoize = true;
+	HandleSet seen;
+	for (const Handle& ho : oset)
+	{
+		FindAtoms fv(_varlist->varset);
+		fv.search_set(ho);
+		for (const Handle& v : fv.varset)
+			if (not seen.insert(v).second) gb.memoize = false;
+	}
 
-				tc = (tree_compare(glob, osg[jg], CALL_GLOB) and
-				      _varlist->is_upper_bound(ohp, 1));
-				if (not tc)
-				{
-					match = false;
-					break;
-				}
+	_glob_bounds.emplace(h, gb);
+}
 
-				glob_seq.push_back(osg[jg]);
-				jg++;
+/// Compare a link holding globs to its proposed grounding. Each glob
+/// may match any number of atoms in a row, within its interval, and
+/// so this is a search over where each glob ends. It is depth-first,
+/// trying the shortest extent of each glob first, and so it finds the
+/// splits in lexicographic order. The length bounds prune the extents
+/// that leave too few, or too many atoms for the rest of the pattern,
+/// and the (pattern, grounding) offsets that were found to fail are
+/// not tried again. Together, these keep the search for the next split
+/// quadratic in the length of the link, instead of exponential in the
+/// number of globs.
+///
+/// The split that was found is kept in _glob_state; if glob_next is
+/// set, the search resumes after it, so that explore_glob_branches()
+/// can step through every split, the same way that the permutations
+/// of unordered links are stepped through.
+bool PatternMatchEngine::glob_compare(const PatternTermPtr& ptm,
+                                      const Handle& hg)
+{
+	const Handle& hp = ptm->getHandle();
+	auto gbit = _glob_bounds.find(hp);
+	if (_glob_bounds.end() == gbit)
+	{
+		add_glob_bounds(hp);
+		gbit = _glob_bounds.find(hp);
+	}
 
-				// Can we match more?
-				while (tc and jg<osg_size)
-				{
-					if (have_post)
-					{
-						// If the atom after the glob matches, then we are done.
-						tc = tree_compare(post_glob, osg[jg], CALL_GLOB);
-						if (tc) break;
-					}
-					tc = (tree_compare(glob, osg[jg], CALL_GLOB) and
-					      _varlist->is_upper_bound(ohp, glob_seq.size()+1));
-					if (tc) glob_seq.push_back(osg[jg]);
-					jg ++;
-				}
-				jg --;
-				if (not tc or not _varlist->is_lower_bound(ohp, glob_seq.size()))
-				{
-					match = false;
-					break;
-				}
+	// If asked to step, resume after the last split. If there is no
+	// last split, then this link failed to match last time around,
+	// and there is nothing to step to.
+	GlobPair gp(ptm, hg);
+	const GlobSplit* after = nullptr;
+	bool stepping = glob_next;
+	if (stepping)
+	{
+		glob_next = false; // we are taking a step, so clear the flag.
+		glob_stepped = false;
+		auto gsit = _glob_state.find(gp);
+		if (_glob_state.end() == gsit) return false;
+		after = &gsit->second;
+	}
 
-				// If we are here, we've got a match; record the glob.
-				LinkPtr glp(createLink(glob_seq, LIST_LINK));
-				var_grounding[glob->getHandle()] = glp->getHandle();
-			}
-			else
-			{
-				// If we are here, we are not comparing to a glob.
+	PatternTermSeq osp = ptm->getOutgoingSet();
+	const HandleSeq& osg = hg->getOutgoingSet();
+	GlobSearch gs{osp, osg, gbit->second, {},
+	              GlobSplit(osp.size()+1, 0), after};
+	if (gs.bounds.memoize)
+		gs.failed.resize((osp.size()+1) * (osg.size()+1), false);
 
-				// If we have already gone through all the atoms in
-				// the candidate, or the current pair does not match,
-				// reject it.
-				if (grd_end or not tree_compare(osp[ip], osg[jg], CALL_ORDER))
-				{
-					match = false;
-					break;
-				}
-			}
-		}
+	if (not glob_step(gs, 0, 0, nullptr != after))
+	{
+		// If we are here, we've explored all the possibilities already
+		_glob_state.erase(gp);
+		return false;
 	}
+	_glob_state[gp] = gs.split;
+	if (stepping) glob_stepped = true;
+	return true;
+}
 
-	depth --;
-	DO_LOG({LAZY_LOG_FINE << "tree_comp down link match=" << match;})
+/// Match the pattern from offset `ip` onwards to the grounding from
+/// offset `jg` onwards. If `tight` is set, the split so far is the
+/// same as `gs.after`, and only the splits that come after it may be
+/// reported. On failure, any groundings made along the way are undone.
+bool PatternMatchEngine::glob_step(GlobSearch& gs, size_t ip, size_t jg,
+                                   bool tight)
+{
+	size_t osp_size = gs.osp.size();
+	size_t osg_size = gs.osg.size();
+	gs.split[ip] = jg;
 
-	const Handle &hp = ptm->getHandle();
-	if (not match)
-	{
-		_pmc.post_link_mismatch(hp, hg);
+	// A tight split that got to the end is the one reported last time.
+	if (ip == osp_size) return jg == osg_size and not tight;
+
+	size_t left = osg_size - jg;
+	if (left < gs.bounds.min_rest[ip] or gs.bounds.max_rest[ip] < left)
 		return false;
+
+	// Failures of tight searches are not memoized: they only skipped
+	// the splits that had been reported already.
+	size_t memo = ip * (osg_size+1) + jg;
+	if (not tight and gs.bounds.memoize and gs.failed[memo]) return false;
+
+	const PatternTermPtr& ptm = gs.osp[ip];
+	const Handle& ohp = ptm->getHandle();
+	size_t mark = _trail.size();
+
+	if (GLOB_NODE != ohp->getType())
+	{
+		// If we are here, we are not comparing to a glob.
+		if (tree_compare(ptm, gs.osg[jg], CALL_ORDER) and
+		    glob_step(gs, ip+1, jg+1, tight))
+			return true;
 	}
+	else
+	{
+		// The glob must leave enough atoms for the rest of the pattern,
+		// and not so many that the rest cannot take them up.
+		size_t lo = gs.bounds.min_len[ip];
+		size_t hi = std::min(gs.bounds.max_len[ip],
+		                     left - gs.bounds.min_rest[ip+1]);
+		if (gs.bounds.max_rest[ip+1] < left)
+			lo = std::max(lo, left - gs.bounds.max_rest[ip+1]);
+
+		// When resuming, shorter extents than last time were all
+		// explored already.
+		size_t last = tight ? (*gs.after)[ip+1] - jg : 0;
+
+		HandleSeq glob_seq;
+		for (size_t n = 0; lo <= hi and n <= hi; n++)
+		{
+			if (0 < n)
+			{
+				const Handle& hn = gs.osg[jg+n-1];
 
-	// If we've found a grounding, lets see if the
-	// post-match callback likes this grounding.
-	match = _pmc.post_link_match(hp, hg);
-	if (not match) return false;
+				// GlobNodes cannot match themselves -- no self-grounding
+				// is allowed. TODO -- maybe this check should be moved
+				// to the clause_match() callback?
+				if (ohp == hn) break;
+				if (not tree_compare(ptm, hn, CALL_GLOB)) break;
+				glob_seq.push_back(hn);
+			}
+			if (n < lo or n < last) continue;
 
-	// If we've found a grounding, record it.
-	if (hp != hg) var_grounding[hp] = hg;
+			// Record the glob, and see if the rest fits. A glob that
+			// matches nothing is grounded by an empty ListLink.
+			LinkPtr glp(createLink(glob_seq, LIST_LINK));
+			ground(var_grounding, ohp, glp->getHandle());
+			if (glob_step(gs, ip+1, jg+n, tight and n == last))
+				return true;
+			undo_to(mark);
+		}
+	}
 
-	return true;
+	undo_to(mark);
+	if (not tight and gs.bounds.memoize) gs.failed[memo] = true;
+	return false;
+}
+
+/// Return true if the term, or any term below it, holds globs.
+bool PatternMatchEngine::holds_globs(const PatternTermPtr& ptm)
+{
+	if (0 < _pat->globby_terms.count(ptm->getHandle())) return true;
+	for (const PatternTermPtr& sub : ptm->getOutgoingSet())
+		if (holds_globs(sub)) return true;
+	return false;
 }
 
 /* ======================================================== */
@@ -428,7 +506,7 @@ bool PatternMatchEngine::choice_compare(const PatternTermPtr& ptm,
 				solution_drop();
 
 				// If the grounding is accepted, record it.
-				if (hp != hg) var_grounding[hp] = hg;
+				if (hp != hg) ground(var_grounding, hp, hg);
 
 				_choice_state[GndChoice(ptm, hg)] = icurr;
 				return true;
@@ -469,6 +547,59 @@ bool PatternMatchEngine::have_choice(const PatternTermPtr& ptm,
 	return 0 < _choice_state.count(GndChoice(ptm, hg));
 }
 
+/* ======================================================== */
+
+/// Return true if the term holds an unordered link or a ChoiceLink,
+/// anywhere below it. These are branchpoints; tree_compare() on such
+/// a term changes the stepping state, as well as the groundings.
+static bool has_branchpoints(const PatternTermPtr& ptm)
+{
+	for (const PatternTermPtr& sub : ptm->getOutgoingSet())
+	{
+		const Handle& h = sub->getHandle();
+		if (not h->isLink()) continue;
+
+		Type t = h->getType();
+		if (CHOICE_LINK == t) return true;
+		if (2 <= h->getArity() and
+		    not classserver().isA(t, ORDERED_LINK)) return true;
+		if (has_branchpoints(sub)) return true;
+	}
+	return false;
+}
+
+/// Try to extend the pairing of rows with columns, starting at row i,
+/// by finding an augmenting path (Kuhn's algorithm).
+static bool augment(size_t i, const std::vector<std::vector<char>>& rows,
+                    std::vector<size_t>& col_owner, std::vector<char>& seen)
+{
+	for (size_t j=0; j<rows[i].size(); j++)
+	{
+		if (not rows[i][j] or seen[j]) continue;
+		seen[j] = true;
+		if (SIZE_MAX == col_owner[j] or
+		    augment(col_owner[j], rows, col_owner, seen))
+		{
+			col_owner[j] = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+/// Return true if every row can be paired with a distinct column,
+/// using only the pairs marked in the (square) compatibility matrix.
+static bool perfect_matching(const std::vector<std::vector<char>>& rows)
+{
+	std::vector<size_t> col_owner(rows.size(), SIZE_MAX);
+	for (size_t i=0; i<rows.size(); i++)
+	{
+		std::vector<char> seen(rows.size(), false);
+		if (not augment(i, rows, col_owner, seen)) return false;
+	}
+	return true;
+}
+
 /* ======================================================== */
 static int facto (int n) { return (n==1)? 1 : n * facto(n-1); };
 
@@ -631,6 +762,37 @@ bool PatternMatchEngine::unorder_compare(const PatternTermPtr& ptm,
 	OC_ASSERT (not (take_step and have_more),
 	           "Impossible situation! BUG!");
 
+	// Work out, up front, which members could possibly be grounded
+	// by which outgoing atoms. This is only safe if the members hold
+	// no branchpoints of their own: skipping the tree_compare() of a
+	// nested unordered or choice link would upset its stepping state.
+	bool prune = not has_branchpoints(ptm);
+	std::map<PatternTermPtr, std::vector<char>> compat;
+	if (prune)
+	{
+		std::vector<std::vector<char>> rows;
+		for (const PatternTermPtr& mem : osp)
+		{
+			std::vector<char>& row = compat[mem];
+			for (size_t j=0; j<arity; j++)
+				row.push_back(may_match(mem, osg[j]));
+			rows.push_back(row);
+		}
+
+		// No permutation at all can work, if the members cannot be
+		// paired off with the outgoing atoms, one-to-one.
+		if (not perfect_matching(rows))
+		{
+			DO_LOG({LAZY_LOG_FINE << "No feasible permutation of term="
+			              << ptm->toString();})
+			_pmc.post_link_mismatch(hp, hg);
+			_perm_state.erase(Unorder(ptm, hg));
+			take_step = false;
+			have_more = false;
+			return false;
+		}
+	}
+
 	// _perm_state lets use resume where we last left off.
 	bool fresh = false;
 	Permutation mutation = curr_perm(ptm, hg, fresh);
@@ -651,9 +813,32 @@ bool PatternMatchEngine::unorder_compare(const PatternTermPtr& ptm,
 #endif
 	do
 	{
+		// If the member in position i cannot ground osg[i], then
+		// neither can any other permutation that starts with the same
+		// i+1 members. Sorting the tail into descending order makes
+		// this the last such permutation, so that next_permutation()
+		// moves on to a new prefix. None of the skipped permutations
+		// ever reaches tree_compare(), so this is just like stepping
+		// through them one at a time, each failing (case 8).
+		if (prune)
+		{
+			size_t bad = 0;
+			while (bad < arity and compat[mutation[bad]][bad]) bad++;
+			if (bad < arity)
+			{
+				std::sort(mutation.begin() + bad + 1, mutation.end(),
+				          std::greater<PatternTermPtr>());
+				_pmc.post_link_mismatch(hp, hg);
+				take_step = false;
+				have_more = false;
+				continue;
+			}
+		}
+
 		DO_LOG({LAZY_LOG_FINE << "tree_comp explore unordered perm "
 		              << perm_count[Unorder(ptm, hg)] << " of " << num_perms
 		              << " of term=" << ptm->toString();})
+		PM_PROFILE(_profile, _profile->permutations++)
 		solution_push();
 		bool match = true;
 		for (size_t i=0; i<arity; i++)
@@ -698,7 +883,7 @@ bool PatternMatchEngine::unorder_compare(const PatternTermPtr& ptm,
 				solution_drop();
 
 				// If the grounding is accepted, record it.
-				if (hp != hg) var_grounding[hp] = hg;
+				if (hp != hg) ground(var_grounding, hp, hg);
 
 				// Handle case 5&7 of description above.
 				have_more = true;
@@ -733,6 +918,52 @@ take_next_step:
 	return false;
 }
 
+/// A quick check of whether tree_compare() could possibly accept hg
+/// as a grounding of ptm. It records no groundings, and it calls no
+/// callbacks other than variable_match() and node_match(). It never
+/// rejects anything that tree_compare() would accept: it looks only
+/// at existing groundings, variable and node constraints, and at the
+/// link types and sizes (which every link_match() insists on). It
+/// does not look inside unordered links, ChoiceLinks, or anything
+/// evaluatable. It is used to prune the permutations explored by
+/// unorder_compare().
+bool PatternMatchEngine::may_match(const PatternTermPtr& ptm,
+                                   const Handle& hg)
+{
+	const Handle& hp = ptm->getHandle();
+
+	auto gnd = var_grounding.find(hp);
+	if (var_grounding.end() != gnd) return (gnd->second == hg);
+
+	Type tp = hp->getType();
+	if (not ptm->isQuoted())
+	{
+		if (_varlist->varset.end() != _varlist->varset.find(hp))
+			return _pmc.variable_match(hp, hg);
+		if (VARIABLE_NODE == tp) return true;
+	}
+
+	if (is_evaluatable(hp) or is_executable(hp)) return true;
+	if (hp == hg) return true;
+
+	// A node pattern against a link is left to fuzzy_match().
+	if (hp->isNode()) return hg->isLink() or _pmc.node_match(hp, hg);
+	if (not hg->isLink() or CHOICE_LINK == tp) return true;
+
+	if (tp != hg->getType()) return false;
+	if (0 < _pat->globby_terms.count(hp)) return true;
+	if (hp->getArity() != hg->getArity()) return false;
+
+	// Ordered links are compared side by side; look at each pair.
+	if (2 <= hp->getArity() and not _classserver.isA(tp, ORDERED_LINK))
+		return true;
+
+	const HandleSeq& osg = hg->getOutgoingSet();
+	PatternTermSeq osp = ptm->getOutgoingSet();
+	for (size_t i=0; i<osp.size(); i++)
+		if (not may_match(osp[i], osg[i])) return false;
+	return true;
+}
 
 /// Compare a PatternTermPtr with a clause taking in consideration
 /// quoting or unquoting operations.
@@ -831,6 +1062,11 @@ bool PatternMatchEngine::tree_compare(const PatternTermPtr& ptm,
                                       Caller caller)
 {
 	const Handle& hp = ptm->getHandle();
+	PM_PROFILE(_profile, _profile->tree_compares++)
+
+	// Once the budget is used up, nothing matches any more; the
+	// search unwinds, and explore_neighborhood() halts it.
+	if (_budget and _budget->charge_compare()) return false;
 
 	// Do we already have a grounding for this? If we do, and the
 	// proposed grounding is the same as before, then there is
@@ -995,12 +1231,21 @@ bool PatternMatchEngine::explore_term_branches(const Handle& term,
 /// explored.  Thus, this returns true only if entire pattern was
 /// grounded.
 ///
+/// If `child` is a term whose grounding `hg` is known, then `ptm`,
+/// its parent, can only be grounded by links having `hg` in the same
+/// place as the pattern has `child` -- as long as `ptm` is an ordered
+/// link without globs in it. The callback is asked for just those.
+///
 bool PatternMatchEngine::explore_up_branches(const PatternTermPtr& ptm,
+                                             const PatternTermPtr& child,
                                              const Handle& hg,
                                              const Handle& clause_root)
 {
 	// Move up the solution graph, looking for a match.
-	IncomingSet iset = _pmc.get_incoming_set(hg);
+	Arity pos;
+	IncomingSet iset = term_position(ptm, child, pos) ?
+		_pmc.get_incoming_by_position(hg, ptm->getHandle()->getType(), pos) :
+		_pmc.get_incoming_set(hg);
 	size_t sz = iset.size();
 	DO_LOG({LAZY_LOG_FINE << "Looking upward for term=" << ptm->toString()
 	              << " have " << sz << " branches";})
@@ -1017,6 +1262,33 @@ bool PatternMatchEngine::explore_up_branches(const PatternTermPtr& ptm,
 	return found;
 }
 
+/// Find the position of `child` in the outgoing set of `parent`.
+/// Returns false if the position tells nothing about where the
+/// grounding of `child` sits in the grounding of `parent`: for
+/// unordered links, ChoiceLinks, links with globs in them, and when
+/// quotes are involved.
+bool PatternMatchEngine::term_position(const PatternTermPtr& parent,
+                                       const PatternTermPtr& child,
+                                       Arity& pos)
+{
+	const Handle& hp = parent->getHandle();
+	Type tp = hp->getType();
+	if (CHOICE_LINK == tp or _classserver.isA(tp, UNORDERED_LINK) or
+	    Quotation::is_quotation_type(tp) or
+	    Quotation::is_quotation_type(child->getHandle()->getType()))
+		return false;
+
+	for (const Handle& ho : hp->getOutgoingSet())
+		if (GLOB_NODE == ho->getType()) return false;
+
+	const PatternTermSeq& osp = parent->getOutgoingSet();
+	Arity arity = osp.size();
+	if (arity != hp->getArity()) return false;
+	for (pos = 0; pos < arity; pos++)
+		if (osp[pos] == child) return true;
+	return false;
+}
+
 /// explore_link_branches -- verify the suggested grounding.
 ///
 /// There are two ways to understand this method. In the "simple" case,
@@ -1059,7 +1331,7 @@ bool PatternMatchEngine::explore_link_branches(const PatternTermPtr& ptm,
 	// all permutations.
 	Type tp = hp->getType();
 	if (not _classserver.isA(tp, UNORDERED_LINK))
-		return explore_choice_branches(ptm, hg, clause_root);
+		return explore_glob_branches(ptm, hg, clause_root);
 
 	do {
 		// If the pattern was satisfied, then we are done for good.
@@ -1078,6 +1350,47 @@ bool PatternMatchEngine::explore_link_branches(const PatternTermPtr& ptm,
 	return false;
 }
 
+/// See explore_link_branches() for a general explanation. This method
+/// handles the different ways of splitting the grounding among globs:
+/// each split is explored in turn, until one of them grounds the whole
+/// pattern, or none are left. Only the first link with globs that
+/// tree_compare() meets below the term is stepped, much as for the
+/// ChoiceLinks.
+bool PatternMatchEngine::explore_glob_branches(const PatternTermPtr& ptm,
+                                               const Handle& hg,
+                                               const Handle& clause_root)
+{
+	// If it holds no globs, then don't try to iterate.
+	if (_pat->globby_terms.empty() or not holds_globs(ptm))
+		return explore_choice_branches(ptm, hg, clause_root);
+
+	// The flags belong to whoever is stepping; an enclosing loop,
+	// further down the stack, gets them back when we are done.
+	bool saved_stepped = glob_stepped;
+	glob_next = false;
+
+	DO_LOG({logger().fine("Begin glob branchpoint iteration loop");})
+	bool found = explore_choice_branches(ptm, hg, clause_root);
+	while (not found)
+	{
+		DO_LOG({logger().fine("Step to next glob split");})
+		// If we are here, there was no match. Take a step, and
+		// try again.
+		glob_next = true;
+		glob_stepped = false;
+		found = explore_choice_branches(ptm, hg, clause_root);
+
+		// Stop if the compare ran out of splits, or if it stopped
+		// before it got to the globs, so that the step was not taken.
+		if (glob_next or not glob_stepped) break;
+	}
+	glob_next = false;
+	glob_stepped = saved_stepped;
+
+	DO_LOG({logger().fine("Exhausted all glob splits");})
+	return found;
+}
+
 /// See explore_link_branches() for a general explanation. This method
 /// handles the ChoiceLink branch alternatives only.  It assumes
 /// that the caller had handled the unordered-link alternative branches.
@@ -1275,7 +1588,7 @@ bool PatternMatchEngine::do_term_up(const PatternTermPtr& ptm,
 			// the evaluation for the callback.
 // XXX TODO count the number of ungrounded vars !!! (make sure its zero)
 
-			bool found = _pmc.evaluate_sentence(clause_root, var_grounding);
+			bool found = evaluate_sentence(clause_root, var_grounding);
 			DO_LOG({logger().fine("After evaluating clause, found = %d", found);})
 			if (found)
 				return clause_accept(clause_root, hg);
@@ -1293,7 +1606,7 @@ bool PatternMatchEngine::do_term_up(const PatternTermPtr& ptm,
 	bool found = false;
 	if (CHOICE_LINK != hi->getType())
 	{
-		if (explore_up_branches(parent, hg, clause_root)) found = true;
+		if (explore_up_branches(parent, ptm, hg, clause_root)) found = true;
 		DO_LOG({logger().fine("After moving up the clause, found = %d", found);})
 	}
 	else
@@ -1350,7 +1663,7 @@ bool PatternMatchEngine::clause_accept(const Handle& clause_root,
 
 	if (not is_evaluatable(clause_root))
 	{
-		clause_grounding[clause_root] = hg;
+		ground(clause_grounding, clause_root, hg);
 		logmsg("---------------------\nclause:", clause_root);
 		logmsg("ground:", hg);
 	}
@@ -1373,7 +1686,7 @@ bool PatternMatchEngine::do_next_clause(void)
 	bool found = false;
 	if (nullptr == curr_root)
 	{
-		found = _pmc.grounding(var_grounding, clause_grounding);
+		found = report_grounding(var_grounding, clause_grounding);
 		DO_LOG(logger().fine("==================== FINITO! accepted=%d", found);)
 		DO_LOG(log_solution(var_grounding, clause_grounding);)
 	}
@@ -1386,7 +1699,7 @@ bool PatternMatchEngine::do_next_clause(void)
 		              << (is_evaluatable(curr_root)?
 		                  "dynamically evaluatable" : "non-dynamic");
 		logmsg("Joining variable is", joiner);
-		logmsg("Joining grounding is", var_grounding[joiner]); })
+		logmsg("Joining grounding is", joint_grounding(joiner)); })
 
 		// Else, start solving the next unsolved clause. Note: this is
 		// a recursive call, and not a loop. Recursion is halted when
@@ -1398,7 +1711,7 @@ bool PatternMatchEngine::do_next_clause(void)
 		// else the join is a 'real' atom.
 
 		clause_accepted = false;
-		Handle hgnd(var_grounding[joiner]);
+		Handle hgnd(joint_grounding(joiner));
 		OC_ASSERT(nullptr != hgnd, "Error: joining handle has not been grounded yet!");
 		found = explore_clause(joiner, hgnd, curr_root);
 
@@ -1413,9 +1726,13 @@ bool PatternMatchEngine::do_next_clause(void)
 		// depend on recursion to find additional unmatched optional
 		// clauses; thus we have to explicitly loop over all optional
 		// clauses that don't have matches.
+		//
+		// If the budget ran out, the search for the optional clause
+		// was cut short; its absence has not been established.
 		while ((false == found) and
 		       (false == clause_accepted) and
-		       (is_optional(curr_root)))
+		       (is_optional(curr_root)) and
+		       not (_budget and _budget->stopped()))
 		{
 			Handle undef(Handle::UNDEFINED);
 			bool match = _pmc.optional_clause_match(joiner, undef, var_grounding);
@@ -1426,7 +1743,7 @@ bool PatternMatchEngine::do_next_clause(void)
 			}
 
 			// XXX Maybe should push n pop here? No, maybe not ...
-			clause_grounding[curr_root] = Handle::UNDEFINED;
+			ground(clause_grounding, curr_root, Handle::UNDEFINED);
 			get_next_untried_clause();
 			joiner = next_joint;
 			curr_root = next_clause;
@@ -1436,7 +1753,7 @@ bool PatternMatchEngine::do_next_clause(void)
 			{
 				DO_LOG({logger().fine("==================== FINITO BANDITO!");
 				log_solution(var_grounding, clause_grounding);})
-				found = _pmc.grounding(var_grounding, clause_grounding);
+				found = report_grounding(var_grounding, clause_grounding);
 			}
 			else
 			{
@@ -1444,7 +1761,7 @@ bool PatternMatchEngine::do_next_clause(void)
 				// or not. If it does, we'll recurse. If it does not,
 				// we'll loop around back to here again.
 				clause_accepted = false;
-				Handle hgnd = var_grounding[joiner];
+				Handle hgnd(joint_grounding(joiner));
 				found = explore_term_branches(joiner, hgnd, curr_root);
 			}
 		}
@@ -1538,15 +1855,8 @@ void PatternMatchEngine::get_next_untried_clause(void)
 // can be done in a direct fashion; it resembles the concept of
 // "unit propagation" in the DPLL algorithm.
 //
-// XXX TODO ... Rather than counting the number of variables, we
-// should instead look for one with the smallest incoming set.
-// That is because the very next thing that we do will be to
-// iterate over the incoming set of "pursue" ... so it could be
-// a huge pay-off to minimize this.
-//
-// If there are two ungrounded variables in a clause, then the
-// "thickness" is the *product* of the sizes of the two incoming
-// sets. Thus, the fewer ungrounded variables, the better.
+// This is only a tie-breaker; see fanout() below for the primary
+// cost estimate.
 //
 // Danger: this assumes a suitable dataset, as otherwise, the cost
 // of this "optimization" can add un-necessarily to the overhead.
@@ -1566,6 +1876,49 @@ unsigned int PatternMatchEngine::thickness(const Handle& clause,
 	return count;
 }
 
+// Estimate the cost of grounding the clause `root`, starting from
+// the grounding `gnd` of the joining variable `joint`. The very next
+// thing that the search does is to walk upwards from `gnd`, through
+// its incoming set, to each link that might ground the term holding
+// the joint; each such link is the start of a distinct branch. Only
+// links of the same type as the holding term can possibly match, so
+// only those are counted. Since the incoming set is bucketed by type,
+// this is cheap, and, unlike the size of the entire incoming set, it
+// is not thrown off by atoms that are shared by many different kinds
+// of links (e.g. a PredicateNode used everywhere).
+//
+// If the joint appears in several places in the clause, each place
+// is explored separately, so the costs add.
+size_t PatternMatchEngine::fanout(const Handle& joint,
+                                  const Handle& gnd,
+                                  const Handle& root)
+{
+	auto pl = _pat->connected_terms_map.find({joint, root});
+	if (_pat->connected_terms_map.end() == pl)
+		return gnd->getIncomingSetSize();
+
+	size_t width = 0;
+	for (const PatternTermPtr& ptm : pl->second)
+	{
+		Handle holder(ptm->getParent()->getHandle());
+
+		// The joint is the entire clause; nothing to walk.
+		if (nullptr == holder)
+		{
+			width += 1;
+			continue;
+		}
+
+		// ChoiceLinks do not appear in the grounding; can't tell.
+		Type htype = holder->getType();
+		if (CHOICE_LINK == htype)
+			width += gnd->getIncomingSetSize();
+		else
+			width += gnd->getIncomingSetSizeByType(htype);
+	}
+	return width;
+}
+
 /// Same as above, but with three boolean flags:  if not set, then only
 /// those clauses satsifying the criterion are considered, else all
 /// clauses are considered.
@@ -1582,40 +1935,28 @@ bool PatternMatchEngine::get_next_thinnest_clause(bool search_virtual,
 	// the root is grounded.  If its not, start working on that.
 	Handle joint(Handle::UNDEFINED);
 	Handle unsolved_clause(Handle::UNDEFINED);
-	unsigned int thinnest_joint = UINT_MAX;
+	size_t thinnest_joint = SIZE_MAX;
 	unsigned int thinnest_clause = UINT_MAX;
 	bool unsolved = false;
 
 	// Make a list of the as-yet ungrounded variables.
 	HandleSet ungrounded_vars;
-
-	// Grounded variables ordered by the size of their grounding incoming set
-	std::multimap<std::size_t, Handle> thick_vars;
-
 	for (const Handle &v : _varlist->varset)
 	{
-		auto gnd = var_grounding.find(v);
-		if (gnd != var_grounding.end())
-		{
-			std::size_t incoming_set_size = gnd->second->getIncomingSetSize();
-			thick_vars.insert(std::make_pair(incoming_set_size, v));
-		}
-		else ungrounded_vars.insert(v);
+		if (var_grounding.find(v) == var_grounding.end())
+			ungrounded_vars.insert(v);
 	}
 
 	// We are looking for a joining atom, one that is shared in common
 	// with the a fully grounded clause, and an as-yet ungrounded clause.
 	// The joint is called "pursue", and the unsolved clause that it
-	// joins will become our next untried clause. We choose joining atom
-	// with smallest size of its incoming set. If there are many such
-	// atoms we choose one from clauses with minimal number of ungrounded
-	// yet variables.
-	for (auto tckvar : thick_vars)
+	// joins will become our next untried clause. We choose the pair
+	// with the smallest estimated fanout; if there are many such,
+	// we choose the clause with the fewest ungrounded variables.
+	for (const Handle &pursue : _varlist->varset)
 	{
-		std::size_t pursue_thickness = tckvar.first;
-		const Handle& pursue = tckvar.second;
-
-		if (pursue_thickness > thinnest_joint) break;
+		auto gnd = var_grounding.find(pursue);
+		if (gnd == var_grounding.end()) continue;
 
 		auto root_list = _pat->connectivity_map.equal_range(pursue);
 
@@ -1627,11 +1968,15 @@ bool PatternMatchEngine::get_next_thinnest_clause(bool search_virtual,
 			        and (search_black or not is_black(root))
 			        and (search_optionals or not is_optional(root)))
 			{
+				size_t root_fanout = fanout(pursue, gnd->second, root);
+				if (thinnest_joint < root_fanout) continue;
+
 				unsigned int root_thickness = thickness(root, ungrounded_vars);
-				if (root_thickness < thinnest_clause)
+				if (root_fanout < thinnest_joint
+				    or root_thickness < thinnest_clause)
 				{
 					thinnest_clause = root_thickness;
-					thinnest_joint = pursue_thickness;
+					thinnest_joint = root_fanout;
 					unsolved_clause = root;
 					joint = pursue;
 					unsolved = true;
@@ -1651,7 +1996,7 @@ bool PatternMatchEngine::get_next_thinnest_clause(bool search_virtual,
 
 		if (unsolved_clause)
 		{
-			issued.insert(unsolved_clause);
+			issue(unsolved_clause);
 			return true;
 		}
 	}
@@ -1659,6 +2004,143 @@ bool PatternMatchEngine::get_next_thinnest_clause(bool search_virtual,
 	return false;
 }
 
+/**
+ * Work out, without grounding anything, the order in which the
+ * clauses would be taken up if the search starts with the clause
+ * `root`. This mimics get_next_untried_clause(): the mandatory
+ * clauses first, then the evaluatable and black-box ones, and then
+ * the optionals, each time picking a clause that is joined to the
+ * ones before it by a variable. Since there are no groundings yet,
+ * the fanout of the joint cannot be counted, as fanout() does; it is
+ * estimated from the statistics of the atomspace instead, if there
+ * are any (see estimate_fanout()). The clause with the smallest
+ * estimate is picked; on ties, or without statistics, the one with
+ * the fewest not-yet-bound variables. Thus, this is only an estimate
+ * of what the search will actually do.
+ */
+std::vector<SearchPlan::Step>
+PatternMatchEngine::plan_clauses(const Handle& root, TypeStats* stats)
+{
+	std::vector<SearchPlan::Step> steps;
+	HandleSet bound;
+	HandleSet done;
+
+	auto add_step = [&](const Handle& clause, const Handle& joint,
+	                    double fanout)
+	{
+		SearchPlan::Step st;
+		st.clause = clause;
+		st.joint = joint;
+		st.fanout = fanout;
+		st.unbound = 0;
+		st.type_count = 0;
+		st.optional = is_optional(clause);
+		st.evaluatable = is_evaluatable(clause);
+		st.black = is_black(clause);
+		for (const Handle& v : _varlist->varset)
+		{
+			if (bound.count(v) or not is_unquoted_in_tree(clause, v))
+				continue;
+			st.unbound++;
+			bound.insert(v);
+		}
+		done.insert(clause);
+		steps.push_back(st);
+	};
+
+	add_step(root, Handle::UNDEFINED, 0.0);
+
+	// The same tiers as get_next_untried_clause(), in the same order.
+	static const bool tiers[6][3] = {
+		{false, false, false}, {true, false, false}, {true, true, false},
+		{false, false, true}, {true, false, true}, {true, true, true}};
+
+	while (true)
+	{
+		Handle next;
+		Handle joint;
+		double cheapest = 0.0;
+		unsigned int thinnest = UINT_MAX;
+		for (const auto& tier : tiers)
+		{
+			for (const Handle& pursue : _varlist->varset)
+			{
+				if (not bound.count(pursue)) continue;
+				auto root_list = _pat->connectivity_map.equal_range(pursue);
+				for (auto it = root_list.first; it != root_list.second; it++)
+				{
+					const Handle& clause = it->second;
+					if (done.count(clause)
+					    or (not tier[0] and is_evaluatable(clause))
+					    or (not tier[1] and is_black(clause))
+					    or (not tier[2] and is_optional(clause)))
+						continue;
+
+					double cost = estimate_fanout(pursue, clause, stats);
+					if (next and cheapest < cost) continue;
+
+					unsigned int thick = 0;
+					for (const Handle& v : _varlist->varset)
+						if (not bound.count(v) and is_unquoted_in_tree(clause, v))
+							thick++;
+					if (nullptr == next or cost < cheapest or thick < thinnest)
+					{
+						cheapest = cost;
+						thinnest = thick;
+						next = clause;
+						joint = pursue;
+					}
+				}
+			}
+			if (next) break;
+		}
+		if (nullptr == next) break;
+		add_step(next, joint, cheapest);
+	}
+	return steps;
+}
+
+// The counterpart of fanout(), for when the joint has no grounding:
+// the expected number of links of the type of each term holding the
+// joint in the clause, that hold an atom the search has reached.
+// Zero, that is, no preference, when there are no statistics.
+double PatternMatchEngine::estimate_fanout(const Handle& joint,
+                                           const Handle& root,
+                                           TypeStats* stats)
+{
+	if (nullptr == stats) return 0.0;
+
+	auto pl = _pat->connected_terms_map.find({joint, root});
+	if (_pat->connected_terms_map.end() == pl) return 0.0;
+
+	double width = 0.0;
+	for (const PatternTermPtr& ptm : pl->second)
+	{
+		Handle holder(ptm->getParent()->getHandle());
+		if (nullptr == holder)
+		{
+			width += 1.0;
+			continue;
+		}
+
+		// ChoiceLinks do not appear in the grounding; the link above
+		// the choice is the one that holds the joint.
+		Type htype = holder->getType();
+		if (CHOICE_LINK == htype)
+		{
+			PatternTermPtr above(ptm->getParent()->getParent());
+			if (nullptr == above or nullptr == above->getHandle())
+			{
+				width += 1.0;
+				continue;
+			}
+			htype = above->getHandle()->getType();
+		}
+		width += stats->expected_fanout(htype);
+	}
+	return width;
+}
+
 /* ======================================================== */
 /**
  * Push all stacks related to the grounding of a clause. This push is
@@ -1680,10 +2162,9 @@ void PatternMatchEngine::clause_stacks_push(void)
 	DO_LOG({logger().fine("--- That's it, now push to stack depth=%d",
 	              _clause_stack_depth);})
 
-	var_solutn_stack.push(var_grounding);
-	term_solutn_stack.push(clause_grounding);
+	solution_push();
+	_issued_marks.push_back(_issued_trail.size());
 
-	issued_stack.push(issued);
 	choice_stack.push(_choice_state);
 
 	perm_push();
@@ -1702,9 +2183,16 @@ void PatternMatchEngine::clause_stacks_pop(void)
 	_pmc.pop();
 
 	// The grounding stacks are handled differently.
-	POPSTK(term_solutn_stack, clause_grounding);
-	POPSTK(var_solutn_stack, var_grounding);
-	POPSTK(issued_stack, issued);
+	solution_pop();
+
+	OC_ASSERT(not _issued_marks.empty(), "Unbalanced stack _issued_marks");
+	size_t mark = _issued_marks.back();
+	_issued_marks.pop_back();
+	while (mark < _issued_trail.size())
+	{
+		issued.erase(_issued_trail.back());
+		_issued_trail.pop_back();
+	}
 
 	POPSTK(choice_stack, _choice_state);
 
@@ -1726,36 +2214,95 @@ void PatternMatchEngine::clause_stacks_clear(void)
 {
 	_clause_stack_depth = 0;
 #if 0
-	OC_ASSERT(0 == term_solutn_stack.size());
-	OC_ASSERT(0 == var_solutn_stack.size());
-	OC_ASSERT(0 == issued_stack.size());
+	OC_ASSERT(0 == _soln_marks.size());
+	OC_ASSERT(0 == _issued_marks.size());
 	OC_ASSERT(0 == choice_stack.size());
 	OC_ASSERT(0 == perm_stack.size());
 #else
-	while (!term_solutn_stack.empty()) term_solutn_stack.pop();
-	while (!var_solutn_stack.empty()) var_solutn_stack.pop();
-	while (!issued_stack.empty()) issued_stack.pop();
+	_soln_marks.clear();
+	_issued_marks.clear();
 	while (!choice_stack.empty()) choice_stack.pop();
 	while (!perm_stack.empty()) perm_stack.pop();
 #endif
 }
 
+/* ======================================================== */
+/*
+ * The groundings are not copied at each choice point; instead, every
+ * change to var_grounding or clause_grounding is logged on a trail,
+ * and a choice point is just the length of the trail at the time.
+ * Backtracking undoes the changes made since then, newest first.
+ * Thus, the cost of a push/pop pair is proportional to the number of
+ * groundings made in between, instead of to the total number of
+ * groundings made so far.
+ */
+
+/// Set gnds[key] = val, recording the previous state on the trail.
+void PatternMatchEngine::ground(HandleMap& gnds,
+                                const Handle& key, const Handle& val)
+{
+	auto it = gnds.lower_bound(key);
+	if (gnds.end() == it or gnds.key_comp()(key, it->first))
+	{
+		_trail.push_back({&gnds, key, Handle::UNDEFINED, false});
+		gnds.emplace_hint(it, key, val);
+		return;
+	}
+	if (it->second == val) return;
+
+	_trail.push_back({&gnds, key, it->second, true});
+	it->second = val;
+}
+
+/// Undo all changes made since the trail had length mark.
+void PatternMatchEngine::undo_to(size_t mark)
+{
+	while (mark < _trail.size())
+	{
+		const Undo& u = _trail.back();
+		if (u.had)
+			(*u.map)[u.key] = u.prev;
+		else
+			u.map->erase(u.key);
+		_trail.pop_back();
+	}
+}
+
+/// The grounding of the joint between two clauses. Ungrounded joints
+/// are recorded as grounded by Handle::UNDEFINED (as operator[] would).
+Handle PatternMatchEngine::joint_grounding(const Handle& joint)
+{
+	auto gnd = var_grounding.find(joint);
+	if (var_grounding.end() != gnd) return gnd->second;
+
+	ground(var_grounding, joint, Handle::UNDEFINED);
+	return Handle::UNDEFINED;
+}
+
+/// Add a clause to the issued set, recording it on the issued trail.
+void PatternMatchEngine::issue(const Handle& clause)
+{
+	if (issued.insert(clause).second)
+		_issued_trail.push_back(clause);
+}
+
 void PatternMatchEngine::solution_push(void)
 {
-	var_solutn_stack.push(var_grounding);
-	term_solutn_stack.push(clause_grounding);
+	_soln_marks.push_back(_trail.size());
 }
 
 void PatternMatchEngine::solution_pop(void)
 {
-	POPSTK(var_solutn_stack, var_grounding);
-	POPSTK(term_solutn_stack, clause_grounding);
+	OC_ASSERT(not _soln_marks.empty(), "Unbalanced stack _soln_marks");
+	undo_to(_soln_marks.back());
+	_soln_marks.pop_back();
 }
 
+/// Discard the most recent choice point, keeping the groundings made
+/// since then. They will be undone along with the enclosing one.
 void PatternMatchEngine::solution_drop(void)
 {
-	var_solutn_stack.pop();
-	term_solutn_stack.pop();
+	_soln_marks.pop_back();
 }
 
 /* ======================================================== */
@@ -1789,8 +2336,16 @@ bool PatternMatchEngine::explore_neighborhood(const Handle& do_clause,
                                               const Handle& term,
                                               const Handle& grnd)
 {
+	// When only explaining the search, decline every candidate.
+	if (_plan) return false;
+
+	// Returning true halts the search, keeping what was found so far.
+	if (_budget and _budget->exhausted()) return true;
+
+	PM_PROFILE(_profile, _profile->explored++)
 	clause_stacks_clear();
-	return explore_redex(term, grnd, do_clause);
+	bool found = explore_redex(term, grnd, do_clause);
+	return found or (_budget and _budget->stopped());
 }
 
 /**
@@ -1836,17 +2391,40 @@ bool PatternMatchEngine::explore_clause(const Handle& term,
 
 		// If found is false, then there's no solution here.
 		// Bail out, return false to try again with the next candidate.
+		PM_PROFILE(_profile, if (not found) _profile->backtracks[clause]++)
 		return found;
 	}
 
 	// If we are here, we have an evaluatable clause on our hands.
 	DO_LOG({logger().fine("Clause is evaluatable; start evaluating it");})
-	bool found = _pmc.evaluate_sentence(clause, var_grounding);
+	bool found = evaluate_sentence(clause, var_grounding);
 	DO_LOG({logger().fine("Post evaluating clause, found = %d", found);})
 	if (found)
-		return clause_accept(clause, grnd);
+		found = clause_accept(clause, grnd);
 
-	return false;
+	PM_PROFILE(_profile, if (not found) _profile->backtracks[clause]++)
+	return found;
+}
+
+/// Report a grounding to the callback. Returns true if the search
+/// should halt: either the callback wants no more, or the budget is
+/// used up.
+bool PatternMatchEngine::report_grounding(const HandleMap& var_soln,
+                                          const HandleMap& term_soln)
+{
+	PM_PROFILE(_profile, _profile->groundings++)
+	bool halt = _pmc.grounding(var_soln, term_soln);
+	if (_budget and _budget->charge_grounding()) return true;
+	return halt;
+}
+
+/// Evaluate a virtual clause, keeping track of the time it took.
+bool PatternMatchEngine::evaluate_sentence(const Handle& clause,
+                                           const HandleMap& gnds)
+{
+	PM_PROFILE(_profile, _profile->virtual_evals++)
+	ProfileTimer vtime(_profile ? &_profile->virtual_seconds : nullptr);
+	return _pmc.evaluate_sentence(clause, gnds);
 }
 
 /**
@@ -1858,6 +2436,7 @@ void PatternMatchEngine::clear_current_state(void)
 	// Clear all state.
 	var_grounding.clear();
 	clause_grounding.clear();
+	_trail.clear();
 
 	depth = 0;
 
@@ -1871,21 +2450,29 @@ void PatternMatchEngine::clear_current_state(void)
 	take_step = true;
 	_perm_state.clear();
 
+	// glob state
+	_glob_state.clear();
+	glob_next = false;
+	glob_stepped = false;
+
 	issued.clear();
+	_issued_trail.clear();
 }
 
 bool PatternMatchEngine::explore_constant_evaluatables(const HandleSeq& clauses)
 {
+	if (_plan) return false;
+
 	bool found = true;
 	for (const Handle& clause : clauses) {
 		if (is_in(clause, _pat->evaluatable_holders)) {
-			found = _pmc.evaluate_sentence(clause, HandleMap());
+			found = evaluate_sentence(clause, HandleMap());
 			if (not found)
 				break;
 		}
 	}
 	if (found)
-		_pmc.grounding(HandleMap(), HandleMap());
+		report_grounding(HandleMap(), HandleMap());
 
 	return found;
 }
@@ -1894,7 +2481,10 @@ PatternMatchEngine::PatternMatchEngine(PatternMatchCallback& pmcb)
 	: _pmc(pmcb),
 	_classserver(classserver()),
 	_varlist(NULL),
-	_pat(NULL)
+	_pat(NULL),
+	_profile(pmcb.get_profile()),
+	_plan(nullptr),
+	_budget(pmcb.get_budget())
 {
 	// current state
 	depth = 0;
@@ -1909,6 +2499,10 @@ PatternMatchEngine::PatternMatchEngine(PatternMatchCallback& pmcb)
 	// unordered link state
 	have_more = false;
 	take_step = true;
+
+	// glob state
+	glob_next = false;
+	glob_stepped = false;
 }
 
 void PatternMatchEngine::set_pattern(const Variables& v,
@@ -1916,6 +2510,7 @@ void PatternMatchEngine::set_pattern(const Variables& v,
 {
 	_varlist = &v;
 	_pat = &p;
+	_glob_bounds.clear();
 }
 
 /* ======================================================== */
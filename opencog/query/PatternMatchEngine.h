@@ -33,9 +33,12 @@
 #include <opencog/atoms/base/ClassServer.h>
 #include <opencog/atoms/pattern/Pattern.h>
 #include <opencog/query/PatternMatchCallback.h>
+#include <opencog/query/SearchPlan.h>
 
 namespace opencog {
 
+class TypeStats;
+
 class PatternMatchEngine
 {
 	// -------------------------------------------
@@ -127,6 +130,24 @@ private:
 	std::map<Unorder, int> perm_count;
 	std::stack<std::map<Unorder, int>> perm_count_stack;
 
+	// -------------------------------------------
+	// Glob state management. For each link holding globs, and its
+	// grounding, the split that was last found: the place in the
+	// grounding where each position of the pattern starts.
+	typedef std::pair<PatternTermPtr, Handle> GlobPair; // Choice
+	typedef std::vector<size_t> GlobSplit;
+	typedef std::map<GlobPair, GlobSplit> GlobState; // ChoiceState
+
+	GlobState _glob_state;
+	bool holds_globs(const PatternTermPtr&);
+
+	// Iteration control for globs. When glob_next is set, the next
+	// glob_compare() resumes the search after the last split, instead
+	// of starting over, and clears it; glob_stepped tells if it found
+	// another split.
+	bool glob_next;
+	bool glob_stepped;
+
 	// --------------------------------------------
 	// Methods and state that select the next clause to be grounded.
 
@@ -135,11 +156,15 @@ private:
 	void get_next_untried_clause(void);
 	bool get_next_thinnest_clause(bool, bool, bool);
 	unsigned int thickness(const Handle&, const HandleSet&);
+	size_t fanout(const Handle&, const Handle&, const Handle&);
 	Handle next_clause;
 	Handle next_joint;
 	// Set of clauses for which a grounding is currently being attempted.
 	typedef HandleSet IssuedSet;
-	IssuedSet issued;     // stacked on issued_stack
+	IssuedSet issued;     // insertions logged on _issued_trail
+	std::vector<Handle> _issued_trail;
+	std::vector<size_t> _issued_marks;
+	void issue(const Handle&);
 
 	// -------------------------------------------
 	// Stack used to store current traversal state for a single
@@ -151,12 +176,21 @@ private:
 	void solution_pop(void);
 	void solution_drop(void);
 
-	// Stacks containing partial groundings.
-	typedef HandleMap SolnMap;
-	std::stack<SolnMap> var_solutn_stack;
-	std::stack<SolnMap> term_solutn_stack;
+	// Undo log ("trail") of changes to var_grounding and
+	// clause_grounding; the pushes above only remember its length.
+	struct Undo
+	{
+		HandleMap* map;
+		Handle key;
+		Handle prev;
+		bool had;    // false if key was not in the map before
+	};
+	std::vector<Undo> _trail;
+	std::vector<size_t> _soln_marks;
+	void ground(HandleMap&, const Handle&, const Handle&);
+	void undo_to(size_t);
+	Handle joint_grounding(const Handle&);
 
-	std::stack<IssuedSet> issued_stack;
 	std::stack<ChoiceState> choice_stack;
 
 	std::stack<PermState> perm_stack;
@@ -191,6 +225,35 @@ private:
 	bool choice_compare(const PatternTermPtr&, const Handle&);
 	bool ordered_compare(const PatternTermPtr&, const Handle&);
 	bool unorder_compare(const PatternTermPtr&, const Handle&);
+
+	// Glob matching. For each link in the pattern that holds globs,
+	// the least and the most number of atoms that each position, and
+	// each tail of positions, can take up. These are worked out by
+	// add_glob_bounds() the first time glob_compare() meets the link,
+	// and kept until set_pattern() clears them.
+	struct GlobBounds
+	{
+		std::vector<size_t> min_len;
+		std::vector<size_t> max_len;
+		std::vector<size_t> min_rest;
+		std::vector<size_t> max_rest;
+		bool memoize;   // No variable appears in two positions.
+	};
+	std::map<Handle, GlobBounds> _glob_bounds;
+	void add_glob_bounds(const Handle&);
+
+	struct GlobSearch
+	{
+		const PatternTermSeq& osp;
+		const HandleSeq& osg;
+		const GlobBounds& bounds;
+		std::vector<bool> failed;   // Indexed by (pattern, ground) offset.
+		GlobSplit split;            // The split being built.
+		const GlobSplit* after;     // Only report splits past this one.
+	};
+	bool glob_compare(const PatternTermPtr&, const Handle&);
+	bool glob_step(GlobSearch&, size_t, size_t, bool);
+	bool may_match(const PatternTermPtr&, const Handle&);
 	bool clause_compare(const PatternTermPtr&, const Handle&);
 
 	// -------------------------------------------
@@ -199,10 +262,14 @@ private:
 	bool explore_clause(const Handle&, const Handle&, const Handle&);
 	bool explore_term_branches(const Handle&, const Handle&,
 	                           const Handle&);
-	bool explore_up_branches(const PatternTermPtr&, const Handle&,
-	                         const Handle&);
+	bool explore_up_branches(const PatternTermPtr&, const PatternTermPtr&,
+	                         const Handle&, const Handle&);
+	bool term_position(const PatternTermPtr&, const PatternTermPtr&,
+	                   Arity&);
 	bool explore_link_branches(const PatternTermPtr&, const Handle&,
 	                           const Handle&);
+	bool explore_glob_branches(const PatternTermPtr&, const Handle&,
+	                           const Handle&);
 	bool explore_choice_branches(const PatternTermPtr&, const Handle&,
 	                             const Handle&);
 	bool explore_single_branch(const PatternTermPtr&, const Handle&,
@@ -211,6 +278,18 @@ private:
 	                const Handle&);
 	bool clause_accept(const Handle&, const Handle&);
 
+	// -------------------------------------------
+	// Search statistics; null unless the callback asked for them.
+	PatternProfile* _profile;
+	bool evaluate_sentence(const Handle&, const HandleMap&);
+
+	// Set only while explaining a search; no grounding is attempted.
+	SearchPlan* _plan;
+
+	// Limits on the search; null unless the callback set some.
+	QueryBudget* _budget;
+	bool report_grounding(const HandleMap&, const HandleMap&);
+
 public:
 	PatternMatchEngine(PatternMatchCallback&);
 	void set_pattern(const Variables&, const Pattern&);
@@ -224,6 +303,28 @@ public:
 	// connected by an AndLink.
 	bool explore_constant_evaluatables(const HandleSeq& clauses);
 
+	// Collect search statistics into the profile. By default, the
+	// profile is the one provided by the callback, if any.
+	void set_profile(PatternProfile* prof) { _profile = prof; }
+	PatternProfile* get_profile(void) const { return _profile; }
+
+	// Stop the search early, once the budget is used up. By default,
+	// the budget is the one provided by the callback, if any.
+	void set_budget(QueryBudget* qb) { _budget = qb; }
+	QueryBudget* get_budget(void) const { return _budget; }
+
+	// Explain, rather than perform, the search: when a plan is set,
+	// every candidate is declined, and nothing is evaluated.
+	void set_plan(SearchPlan* plan) { _plan = plan; }
+	SearchPlan* get_plan(void) const { return _plan; }
+
+	// Estimated order in which the clauses would be grounded, if the
+	// search started at the given clause. The joins are costed with
+	// the statistics, if given.
+	std::vector<SearchPlan::Step> plan_clauses(const Handle&,
+	                                           TypeStats* = nullptr);
+	double estimate_fanout(const Handle&, const Handle&, TypeStats*);
+
 	// Handy-dandy utilities
 	static void log_solution(const HandleMap &vars,
 	                         const HandleMap &clauses);
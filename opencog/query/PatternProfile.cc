@@ -0,0 +1,101 @@
+/*
+ * PatternProfile.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <sstream>
+
+#include <opencog/atoms/base/Atom.h>
+
+#include "PatternProfile.h"
+
+using namespace opencog;
+
+void PatternProfile::clear(void)
+{
+	search_method.clear();
+	root_clause = Handle::UNDEFINED;
+	start_term = Handle::UNDEFINED;
+	candidates = 0;
+	explored = 0;
+	tree_compares = 0;
+	permutations = 0;
+	backtracks.clear();
+	virtual_evals = 0;
+	virtual_seconds = 0.0;
+	transient_spaces = 0;
+	transient_allocs = 0;
+	transient_atoms = 0;
+	groundings = 0;
+	component_groundings = 0;
+	duplicate_groundings = 0;
+	total_seconds = 0.0;
+}
+
+void PatternProfile::merge(const PatternProfile& other)
+{
+	explored += other.explored;
+	tree_compares += other.tree_compares;
+	permutations += other.permutations;
+	for (const auto& bt : other.backtracks)
+		backtracks[bt.first] += bt.second;
+	virtual_evals += other.virtual_evals;
+	virtual_seconds += other.virtual_seconds;
+	transient_spaces += other.transient_spaces;
+	transient_allocs += other.transient_allocs;
+	transient_atoms += other.transient_atoms;
+	groundings += other.groundings;
+	component_groundings += other.component_groundings;
+	duplicate_groundings += other.duplicate_groundings;
+}
+
+std::string PatternProfile::to_string(const std::string& indent) const
+{
+	std::stringstream ss;
+	ss << indent << "search method: " << search_method << std::endl;
+	if (root_clause)
+		ss << indent << "root clause:" << std::endl
+		   << root_clause->toShortString(indent + "   ");
+	if (start_term)
+		ss << indent << "start term:" << std::endl
+		   << start_term->toShortString(indent + "   ");
+	ss << indent << "candidates: " << candidates
+	   << " (explored " << explored << ")" << std::endl;
+	ss << indent << "tree compares: " << tree_compares << std::endl;
+	ss << indent << "permutations: " << permutations << std::endl;
+	for (const auto& bt : backtracks)
+		ss << indent << "backtracks: " << bt.second << " in clause" << std::endl
+		   << bt.first->toShortString(indent + "   ");
+	ss << indent << "virtual evaluations: " << virtual_evals
+	   << " (" << virtual_seconds << " secs)" << std::endl;
+	ss << indent << "scratch atomspaces: " << transient_spaces
+	   << " (allocated " << transient_allocs << ", "
+	   << transient_atoms << " atoms)" << std::endl;
+	ss << indent << "groundings: " << groundings;
+	if (0 < component_groundings)
+		ss << " (component groundings " << component_groundings << ")";
+	if (0 < duplicate_groundings)
+		ss << " (duplicates " << duplicate_groundings << ")";
+	ss << std::endl;
+	ss << indent << "total: " << total_seconds << " secs" << std::endl;
+	return ss.str();
+}
+
+/* ===================== END OF FILE ===================== */
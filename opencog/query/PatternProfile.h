@@ -0,0 +1,129 @@
+/*
+ * PatternProfile.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_PATTERN_PROFILE_H
+#define _OPENCOG_PATTERN_PROFILE_H
+
+#include <chrono>
+#include <map>
+#include <string>
+
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog {
+
+/**
+ * Statistics about a single pattern-matcher search: where it started,
+ * and how much work it did to find its groundings.
+ *
+ * A profile is collected only if the search callback hands one out,
+ * (see PatternMatchCallback::get_profile(); InitiateSearchCB has a
+ * `profile` member for this); otherwise, the engine does no counting
+ * at all. Defining NO_PATTERN_PROFILE compiles the counting out
+ * completely.
+ */
+struct PatternProfile
+{
+	PatternProfile(void) { clear(); }
+
+	// How the search was started: "range", "neighbor", "no-search",
+	// "link-type" or "variable"; see InitiateSearchCB.
+	std::string search_method;
+	Handle root_clause;
+	Handle start_term;
+
+	// Number of candidate groundings of the start term that were
+	// offered, and the number that were actually explored (the search
+	// may halt early).
+	size_t candidates;
+	size_t explored;
+
+	size_t tree_compares;
+	size_t permutations;
+
+	// The number of times the search backed out of each clause.
+	std::map<Handle, size_t> backtracks;
+
+	// Evaluatable (virtual) clauses.
+	size_t virtual_evals;
+	double virtual_seconds;
+
+	// Scratch atomspaces set aside to evaluate them, the number of those
+	// that had to be allocated (rather than taken from the cache), and
+	// the atoms the evaluations left behind in them.
+	size_t transient_spaces;
+	size_t transient_allocs;
+	size_t transient_atoms;
+
+	// Groundings reported to the callback. For patterns with several
+	// components, these are the final, combined groundings; the ones
+	// found for the components, separately, are counted apart.
+	size_t groundings;
+	size_t component_groundings;
+
+	// Groundings that a BindLink did not instantiate, because an
+	// earlier one gave the implicand variables the same values.
+	size_t duplicate_groundings;
+
+	double total_seconds;
+
+	void clear(void);
+
+	/// Add in the counters of a profile collected by a worker thread.
+	void merge(const PatternProfile&);
+
+	std::string to_string(const std::string& indent = "") const;
+};
+
+#ifdef NO_PATTERN_PROFILE
+#define PM_PROFILE(PROF, STUFF)
+#else
+#define PM_PROFILE(PROF, STUFF) if (PROF) { STUFF; }
+#endif
+
+/// Accumulates the time from construction to destruction into the
+/// given counter; does nothing if the counter is null.
+class ProfileTimer
+{
+	private:
+		double* _secs;
+		std::chrono::steady_clock::time_point _start;
+	public:
+#ifdef NO_PATTERN_PROFILE
+		ProfileTimer(double*) {}
+#else
+		ProfileTimer(double* secs) : _secs(secs)
+		{
+			if (_secs) _start = std::chrono::steady_clock::now();
+		}
+		~ProfileTimer()
+		{
+			if (_secs)
+				*_secs += std::chrono::duration<double>(
+					std::chrono::steady_clock::now() - _start).count();
+		}
+#endif
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_PATTERN_PROFILE_H
@@ -7,10 +7,20 @@
 
 #ifdef HAVE_GUILE
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 #include <opencog/guile/SchemeModule.h>
+#include <opencog/query/AttachedRegistry.h>
 
 namespace opencog {
 
+class GroundingCursor;
+class NumberIndex;
+class RecognizerIndex;
+struct SearchPlan;
+
 class PatternSCM : public ModuleWrap
 {
 	protected:
@@ -20,6 +30,31 @@ class PatternSCM : public ModuleWrap
 		bool value_is_type(Handle, Handle);
 		bool type_match(Handle, Handle);
 		Handle type_compose(Handle, Handle);
+
+		// Open cursors, by id.
+		std::map<int, std::shared_ptr<GroundingCursor>> _cursors;
+		int _next_cursor = 0;
+		std::mutex _cursor_mtx;
+		std::shared_ptr<GroundingCursor> get_cursor(int, const char*);
+		int cursor_open(Handle, size_t, size_t, bool);
+		HandleSeq cursor_next(int, size_t);
+		void cursor_close(int);
+
+		SCM handle_or_nil(const Handle&);
+		SCM pattern_profile(Handle, size_t);
+		SCM plan_to_scm(const SearchPlan&);
+		SCM explain(Handle);
+		SCM budgeted_query(Handle, double, size_t, size_t, size_t);
+		HandleSeq batch_query(HandleSeq);
+
+		// Recognizer indexes, one per atomspace.  An index is built
+		// the first time an atomspace is used, and then kept up to
+		// date; see AttachedRegistry.
+		AttachedRegistry<RecognizerIndex> _reco_indexes;
+		Handle recognize(Handle);
+
+		// Uses, and attaches, the number index of the atomspace.
+		HandleSeq number_range(double, double);
 	public:
 		PatternSCM(void);
 		~PatternSCM();
@@ -35,7 +70,13 @@ class PatternSCM : public ModuleWrap
 #include <opencog/guile/SchemeSmob.h>
 
 #include "BindLinkAPI.h"
+#include "GroundingCursor.h"
+#include "NumberIndex.h"
 #include "PatternMatch.h"
+#include "PatternProfile.h"
+#include "QueryBudget.h"
+#include "RecognizerIndex.h"
+#include "SearchPlan.h"
 
 using namespace opencog;
 
@@ -68,6 +109,213 @@ Handle PatternSCM::type_compose(Handle left, Handle right)
 	return opencog::type_compose(left, right);
 }
 
+// ========================================================
+// Cursors. Scheme gets an integer id; the cursor itself stays here
+// until it is closed.
+
+int PatternSCM::cursor_open(Handle query, size_t offset, size_t limit,
+                            bool add_results)
+{
+	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-cursor-open");
+	std::shared_ptr<GroundingCursor> cur =
+		std::make_shared<GroundingCursor>(as, query, offset, limit,
+		                                  add_results);
+
+	std::lock_guard<std::mutex> lck(_cursor_mtx);
+	int id = _next_cursor++;
+	_cursors[id] = cur;
+	return id;
+}
+
+std::shared_ptr<GroundingCursor>
+PatternSCM::get_cursor(int id, const char* fname)
+{
+	std::lock_guard<std::mutex> lck(_cursor_mtx);
+	auto it = _cursors.find(id);
+	if (_cursors.end() == it)
+		throw InvalidParamException(TRACE_INFO,
+			"%s: no open cursor with id %d", fname, id);
+	return it->second;
+}
+
+HandleSeq PatternSCM::cursor_next(int id, size_t n)
+{
+	std::shared_ptr<GroundingCursor> cur =
+		get_cursor(id, "cog-cursor-next");
+
+	HandleSeq results;
+	while (results.size() < n)
+	{
+		Handle h(cur->next());
+		if (nullptr == h) break;
+		results.push_back(h);
+	}
+	return results;
+}
+
+void PatternSCM::cursor_close(int id)
+{
+	std::shared_ptr<GroundingCursor> cur =
+		get_cursor(id, "cog-cursor-close");
+	{
+		std::lock_guard<std::mutex> lck(_cursor_mtx);
+		_cursors.erase(id);
+	}
+	cur->close();
+}
+
+// ========================================================
+// Profiling. The statistics are returned as an association list.
+
+SCM PatternSCM::handle_or_nil(const Handle& h)
+{
+	if (nullptr == h) return SCM_EOL;
+	return SchemeSmob::handle_to_scm(h);
+}
+
+SCM PatternSCM::pattern_profile(Handle query, size_t max_results)
+{
+	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-pattern-profile");
+	PatternProfile prof;
+	Handle result = profile_query(as, query, prof, max_results);
+
+	SCM backtracks = SCM_EOL;
+	for (const auto& bt : prof.backtracks)
+		backtracks = scm_cons(scm_cons(handle_or_nil(bt.first),
+		                               scm_from_size_t(bt.second)),
+		                      backtracks);
+
+#define ENTRY(KEY,VAL) scm_cons(scm_from_utf8_symbol(KEY), VAL)
+	return scm_list_n(
+		ENTRY("result", handle_or_nil(result)),
+		ENTRY("search-method",
+		      scm_from_utf8_string(prof.search_method.c_str())),
+		ENTRY("root-clause", handle_or_nil(prof.root_clause)),
+		ENTRY("start-term", handle_or_nil(prof.start_term)),
+		ENTRY("candidates", scm_from_size_t(prof.candidates)),
+		ENTRY("explored", scm_from_size_t(prof.explored)),
+		ENTRY("tree-compares", scm_from_size_t(prof.tree_compares)),
+		ENTRY("permutations", scm_from_size_t(prof.permutations)),
+		ENTRY("backtracks", backtracks),
+		ENTRY("virtual-evals", scm_from_size_t(prof.virtual_evals)),
+		ENTRY("virtual-seconds", scm_from_double(prof.virtual_seconds)),
+		ENTRY("transient-spaces", scm_from_size_t(prof.transient_spaces)),
+		ENTRY("transient-allocs", scm_from_size_t(prof.transient_allocs)),
+		ENTRY("transient-atoms", scm_from_size_t(prof.transient_atoms)),
+		ENTRY("groundings", scm_from_size_t(prof.groundings)),
+		ENTRY("component-groundings",
+		      scm_from_size_t(prof.component_groundings)),
+		ENTRY("duplicate-groundings",
+		      scm_from_size_t(prof.duplicate_groundings)),
+		ENTRY("total-seconds", scm_from_double(prof.total_seconds)),
+		SCM_UNDEFINED);
+#undef ENTRY
+}
+
+// ========================================================
+// Query plans. Also an association list; each step of the plan is
+// an association list of its own.
+
+SCM PatternSCM::plan_to_scm(const SearchPlan& plan)
+{
+#define ENTRY(KEY,VAL) scm_cons(scm_from_utf8_symbol(KEY), VAL)
+	SCM steps = SCM_EOL;
+	for (auto st = plan.steps.rbegin(); st != plan.steps.rend(); st++)
+		steps = scm_cons(scm_list_n(
+			ENTRY("clause", handle_or_nil(st->clause)),
+			ENTRY("joint", handle_or_nil(st->joint)),
+			ENTRY("fanout", scm_from_double(st->fanout)),
+			ENTRY("unbound", scm_from_uint(st->unbound)),
+			ENTRY("type-count", scm_from_size_t(st->type_count)),
+			ENTRY("optional", scm_from_bool(st->optional)),
+			ENTRY("evaluatable", scm_from_bool(st->evaluatable)),
+			ENTRY("black-box", scm_from_bool(st->black)),
+			SCM_UNDEFINED), steps);
+
+	SCM comps = SCM_EOL;
+	for (auto cp = plan.components.rbegin(); cp != plan.components.rend(); cp++)
+		comps = scm_cons(plan_to_scm(*cp), comps);
+
+	SCM virts = SCM_EOL;
+	for (auto vi = plan.virtuals.rbegin(); vi != plan.virtuals.rend(); vi++)
+		virts = scm_cons(handle_or_nil(*vi), virts);
+
+	return scm_list_n(
+		ENTRY("search-method",
+		      scm_from_utf8_string(plan.search_method.c_str())),
+		ENTRY("root-clause", handle_or_nil(plan.root_clause)),
+		ENTRY("start-term", handle_or_nil(plan.start_term)),
+		ENTRY("anchor", handle_or_nil(plan.anchor)),
+		ENTRY("estimated-candidates",
+		      scm_from_size_t(plan.estimated_candidates)),
+		ENTRY("steps", steps),
+		ENTRY("components", comps),
+		ENTRY("virtuals", virts),
+		SCM_UNDEFINED);
+#undef ENTRY
+}
+
+SCM PatternSCM::explain(Handle query)
+{
+	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-explain");
+	return plan_to_scm(explain_query(as, query));
+}
+
+// ========================================================
+// Budgeted queries. The partial results, and the reason for
+// stopping, are returned as an association list.
+
+SCM PatternSCM::budgeted_query(Handle query, double secs,
+                               size_t compares, size_t groundings,
+                               size_t transients)
+{
+	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-query-budget");
+	QueryBudget budget;
+	budget.max_seconds = secs;
+	budget.max_tree_compares = compares;
+	budget.max_groundings = groundings;
+	budget.max_transient_atoms = transients;
+	Handle result = opencog::budgeted_query(as, query, budget);
+
+#define ENTRY(KEY,VAL) scm_cons(scm_from_utf8_symbol(KEY), VAL)
+	return scm_list_n(
+		ENTRY("result", handle_or_nil(result)),
+		ENTRY("status", scm_from_utf8_symbol(
+		      QueryBudget::status_name(budget.status))),
+		ENTRY("tree-compares", scm_from_size_t(budget.tree_compares)),
+		ENTRY("groundings", scm_from_size_t(budget.groundings)),
+		ENTRY("transient-atoms", scm_from_size_t(budget.transient_atoms)),
+		SCM_UNDEFINED);
+#undef ENTRY
+}
+
+// ========================================================
+
+HandleSeq PatternSCM::batch_query(HandleSeq queries)
+{
+	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-bind-batch");
+	return opencog::batch_query(as, queries);
+}
+
+// ========================================================
+
+Handle PatternSCM::recognize(Handle hlink)
+{
+	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-recognize");
+
+	RecognizerIndex* index = _reco_indexes.attach(as);
+	return opencog::recognize(as, hlink, *index);
+}
+
+// ========================================================
+
+HandleSeq PatternSCM::number_range(double lo, double hi)
+{
+	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-number-range");
+
+	return NumberIndex::attach(as)->range(lo, hi);
+}
+
 // ========================================================
 
 // XXX HACK ALERT This needs to be static, in order for python to
@@ -105,9 +353,38 @@ void PatternSCM::init(void)
 	_binders.push_back(new FunctionWrap(satisfying_set,
 	                   "cog-satisfying-set-first-n", "query"));
 
-	// Rule recognition.
-	_binders.push_back(new FunctionWrap(recognize,
-	                   "cog-recognize", "query"));
+	// Rule recognition, using an index of the stored rules.
+	define_scheme_primitive("cog-recognize",
+		&PatternSCM::recognize, this, "query");
+
+	// The NumberNodes in a range of values, using an index.
+	define_scheme_primitive("cog-number-range",
+		&PatternSCM::number_range, this, "query");
+
+	// Incremental results. A cursor is opened on a BindLink or a
+	// GetLink, and the results are fetched a few at a time.
+	define_scheme_primitive("cog-cursor-open",
+		&PatternSCM::cursor_open, this, "query");
+	define_scheme_primitive("cog-cursor-next",
+		&PatternSCM::cursor_next, this, "query");
+	define_scheme_primitive("cog-cursor-close",
+		&PatternSCM::cursor_close, this, "query");
+
+	// Run a query, and report how the search went.
+	define_scheme_primitive("cog-pattern-profile-first-n",
+		&PatternSCM::pattern_profile, this, "query");
+
+	// Report how a query would be run, without running it.
+	define_scheme_primitive("cog-explain",
+		&PatternSCM::explain, this, "query");
+
+	// Run a list of queries together, sharing common clauses.
+	define_scheme_primitive("cog-bind-batch",
+		&PatternSCM::batch_query, this, "query");
+
+	// Run a query, but give up when it takes too long.
+	define_scheme_primitive("cog-query-budget-prim",
+		&PatternSCM::budgeted_query, this, "query");
 
 	// Fuzzy matching. XXX FIXME. This is not technically
 	// a query functon, and should probably be in some other
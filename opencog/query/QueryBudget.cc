@@ -0,0 +1,141 @@
+/*
+ * QueryBudget.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "QueryBudget.h"
+
+using namespace opencog;
+
+// Reading the clock costs more than a tree comparison; so it is
+// read only once every this many comparisons.
+#define CLOCK_STRIDE 64
+
+QueryBudget::QueryBudget(void) :
+	max_seconds(0.0),
+	max_tree_compares(0),
+	max_groundings(0),
+	max_transient_atoms(0)
+{
+	reset();
+}
+
+QueryBudget::QueryBudget(const QueryBudget& other)
+{
+	*this = other;
+}
+
+/// Copies the limits, and a snapshot of the usage.
+QueryBudget& QueryBudget::operator=(const QueryBudget& other)
+{
+	max_seconds = other.max_seconds;
+	max_tree_compares = other.max_tree_compares;
+	max_groundings = other.max_groundings;
+	max_transient_atoms = other.max_transient_atoms;
+	tree_compares = other.tree_compares.load();
+	groundings = other.groundings.load();
+	transient_atoms = other.transient_atoms.load();
+	status = other.status.load();
+	_deadline = other._deadline;
+	_started = other._started.load();
+	return *this;
+}
+
+void QueryBudget::reset(void)
+{
+	tree_compares = 0;
+	groundings = 0;
+	transient_atoms = 0;
+	status = COMPLETE;
+	_started = false;
+}
+
+void QueryBudget::begin(void)
+{
+	if (_started) return;
+	_started = true;
+	if (0.0 < max_seconds)
+		_deadline = std::chrono::steady_clock::now() +
+			std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<double>(max_seconds));
+}
+
+/// Record the first reason for stopping; later ones are ignored.
+void QueryBudget::halt(Status why)
+{
+	int running = COMPLETE;
+	status.compare_exchange_strong(running, why);
+}
+
+bool QueryBudget::exhausted(void)
+{
+	if (stopped()) return true;
+	if (_started and 0.0 < max_seconds and
+	    _deadline <= std::chrono::steady_clock::now())
+		halt(DEADLINE);
+	return stopped();
+}
+
+/// A limit of N allows N units of work: the one that reaches the
+/// limit is still done, and the search halts right after it.
+void QueryBudget::spend(size_t limit, size_t used, Status why)
+{
+	if (0 < limit and limit <= used) halt(why);
+}
+
+/// Charged before the comparison; refuses it only if the budget was
+/// already spent.
+bool QueryBudget::charge_compare(void)
+{
+	if (stopped()) return true;
+	size_t n = ++tree_compares;
+	spend(max_tree_compares, n, TREE_COMPARES);
+	if (0 == n % CLOCK_STRIDE) exhausted();
+	return false;
+}
+
+/// Charged after the grounding was reported.
+bool QueryBudget::charge_grounding(void)
+{
+	spend(max_groundings, ++groundings, GROUNDINGS);
+	return exhausted();
+}
+
+/// Charged after the evaluation that created the atoms.
+bool QueryBudget::charge_transients(size_t count)
+{
+	spend(max_transient_atoms, transient_atoms += count, TRANSIENTS);
+	return exhausted();
+}
+
+const char* QueryBudget::status_name(int st)
+{
+	switch (st)
+	{
+		case COMPLETE: return "complete";
+		case DEADLINE: return "deadline";
+		case TREE_COMPARES: return "tree-compares";
+		case GROUNDINGS: return "groundings";
+		case TRANSIENTS: return "transient-atoms";
+	}
+	return "unknown";
+}
+
+/* ===================== END OF FILE ===================== */
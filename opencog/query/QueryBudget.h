@@ -0,0 +1,106 @@
+/*
+ * QueryBudget.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_QUERY_BUDGET_H
+#define _OPENCOG_QUERY_BUDGET_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace opencog {
+
+/**
+ * Limits on the amount of work a single pattern-matcher search may
+ * do. When any one of them is used up, the search stops, as if the
+ * callback had asked it to; whatever was found so far is kept, and
+ * `status` says why the search stopped.
+ *
+ * A budget is used only if the search callback hands one out (see
+ * PatternMatchCallback::get_budget(); InitiateSearchCB has a `budget`
+ * member for this). A zero limit means "no limit". The counters are
+ * shared by the worker threads of a parallel search.
+ */
+struct QueryBudget
+{
+	enum Status
+	{
+		COMPLETE,       // not stopped by the budget
+		DEADLINE,       // ran out of time
+		TREE_COMPARES,  // too many term comparisons
+		GROUNDINGS,     // too many groundings
+		TRANSIENTS      // too many atoms created while evaluating
+	};
+
+	QueryBudget(void);
+	QueryBudget(const QueryBudget&);
+	QueryBudget& operator=(const QueryBudget&);
+
+	// Limits; zero means no limit. A limit of N allows N units of
+	// work, and the search stops right after the Nth.
+	double max_seconds;
+	size_t max_tree_compares;
+
+	// Groundings reported by the engine. For patterns with several
+	// components, the groundings of each component count, as well
+	// as the final, combined ones.
+	size_t max_groundings;
+
+	// Atoms created in the scratch atomspace, while evaluating
+	// virtual clauses.
+	size_t max_transient_atoms;
+
+	// Usage so far.
+	std::atomic<size_t> tree_compares;
+	std::atomic<size_t> groundings;
+	std::atomic<size_t> transient_atoms;
+	std::atomic<int> status;
+
+	/// Forget all usage; the clock starts again at the next search.
+	void reset(void);
+
+	/// Start the clock, unless it is already running.
+	void begin(void);
+
+	/// True if the search has to stop.
+	bool stopped(void) const { return COMPLETE != status; }
+
+	// Charge the budget; each returns true if the search has to stop.
+	bool charge_compare(void);
+	bool charge_grounding(void);
+	bool charge_transients(size_t);
+
+	/// Also checks the clock.
+	bool exhausted(void);
+
+	static const char* status_name(int);
+
+private:
+	std::chrono::steady_clock::time_point _deadline;
+	std::atomic<bool> _started;
+	void halt(Status);
+	void spend(size_t, size_t, Status);
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_QUERY_BUDGET_H
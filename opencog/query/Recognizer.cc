@@ -31,6 +31,7 @@
 #include <opencog/atomutils/FindUtils.h>
 
 #include "BindLinkAPI.h"
+#include "RecognizerIndex.h"
 
 namespace opencog {
 
@@ -51,6 +52,9 @@ namespace opencog {
  *    defined...)
  * -- This hasn't been thought through thoroughly. There are almost
  *    surely some weird gotcha's.
+ *
+ * Given a RecognizerIndex, the candidate patterns are taken from the
+ * index, instead of being found by walking the incoming sets.
  */
 class Recognizer :
    public virtual DefaultPatternMatchCB
@@ -64,14 +68,16 @@ class Recognizer :
 		Handle _root;
 		Handle _starter_term;
 		size_t _cnt;
+		RecognizerIndex* _index;
 		bool do_search(PatternMatchEngine*, const Handle&);
+		bool index_search(PatternMatchEngine*);
 		bool loose_match(const Handle&, const Handle&);
 
 	public:
 		HandleSet _rules;
 
-		Recognizer(AtomSpace* as) :
-			DefaultPatternMatchCB(as) {}
+		Recognizer(AtomSpace* as, RecognizerIndex* index = nullptr) :
+			DefaultPatternMatchCB(as), _index(index) {}
 
 		virtual void set_pattern(const Variables& vars,
 		                         const Pattern& pat)
@@ -84,6 +90,14 @@ class Recognizer :
 		virtual bool node_match(const Handle&, const Handle&);
 		virtual bool link_match(const PatternTermPtr&, const Handle&);
 		virtual bool fuzzy_match(const Handle&, const Handle&);
+
+		// The stored patterns may hold globs, so the position of an
+		// atom in them says nothing; offer the whole incoming set.
+		virtual IncomingSet get_incoming_by_position(const Handle& h,
+		                                             Type, Arity)
+		{
+			return get_incoming_set(h);
+		}
 		virtual bool grounding(const HandleMap &var_soln,
 		                       const HandleMap &term_soln);
 };
@@ -138,11 +152,31 @@ bool Recognizer::do_search(PatternMatchEngine* pme, const Handle& top)
 	return false;
 }
 
+/// Try the candidates from the index, starting each search at the
+/// root of the clause.
+bool Recognizer::index_search(PatternMatchEngine* pme)
+{
+	for (const Handle& h: _pattern->cnf_clauses)
+	{
+		_root = h;
+		for (const Handle& cand : _index->candidates(h))
+		{
+			dbgprt("Index candidate (%lu):\n%s\n", _cnt++,
+			       cand->toShortString().c_str());
+			bool found = pme->explore_neighborhood(_root, _root, cand);
+			if (found) return true;
+		}
+	}
+	return false;
+}
+
 bool Recognizer::initiate_search(PatternMatchEngine* pme)
 {
 	const HandleSeq& clauses = _pattern->cnf_clauses;
 
 	_cnt = 0;
+	if (_index) return index_search(pme);
+
 	for (const Handle& h: clauses)
 	{
 		_root = h;
@@ -310,13 +344,14 @@ bool Recognizer::grounding(const HandleMap& var_soln,
 	return false;
 }
 
-Handle opencog::recognize(AtomSpace* as, const Handle& hlink)
+static Handle do_recognize(AtomSpace* as, const Handle& hlink,
+                           RecognizerIndex* index)
 {
 	PatternLinkPtr bl(PatternLinkCast(hlink));
 	if (NULL == bl)
 		bl = createPatternLink(*LinkCast(hlink));
 
-	Recognizer reco(as);
+	Recognizer reco(as, index);
 	bl->satisfy(reco);
 
 	HandleSeq hs;
@@ -324,3 +359,14 @@ Handle opencog::recognize(AtomSpace* as, const Handle& hlink)
 
 	return as->add_link(SET_LINK, hs);
 }
+
+Handle opencog::recognize(AtomSpace* as, const Handle& hlink)
+{
+	return do_recognize(as, hlink, nullptr);
+}
+
+Handle opencog::recognize(AtomSpace* as, const Handle& hlink,
+                          RecognizerIndex& index)
+{
+	return do_recognize(as, hlink, &index);
+}
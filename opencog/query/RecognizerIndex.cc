@@ -0,0 +1,232 @@
+/*
+ * RecognizerIndex.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <boost/bind.hpp>
+
+#include <opencog/atoms/base/Link.h>
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "RecognizerIndex.h"
+
+using namespace opencog;
+
+static bool is_wild(const Handle& h)
+{
+	Type t = h->getType();
+	return VARIABLE_NODE == t or GLOB_NODE == t;
+}
+
+/// Walk the pattern, collecting the constant nodes that a match is
+/// sure to compare (see Recognizer::fuzzy_match()) into `keys`, and
+/// all of the constant nodes into `consts`. Notes whether there are
+/// any variables or globs at all.
+static void find_keys(const Handle& h, bool checked,
+                      UnorderedHandleSet& keys, UnorderedHandleSet& consts,
+                      bool& wild)
+{
+	if (h->isNode())
+	{
+		if (is_wild(h))
+			wild = true;
+		else
+		{
+			consts.insert(h);
+			if (checked) keys.insert(h);
+		}
+		return;
+	}
+
+	const HandleSeq& oset = h->getOutgoingSet();
+	size_t sz = oset.size();
+	bool globby = false;
+	for (const Handle& ho : oset)
+		if (GLOB_NODE == ho->getType()) { globby = true; break; }
+
+	if (not globby)
+	{
+		for (const Handle& ho : oset)
+			find_keys(ho, checked, keys, consts, wild);
+		return;
+	}
+
+	// Next to globs, links are compared by type only, and nothing
+	// is compared after two globs in a row.
+	for (size_t i = 0; i < sz; i++)
+	{
+		const Handle& ho = oset[i];
+		if (GLOB_NODE == ho->getType() and i+1 < sz and
+		    GLOB_NODE == oset[i+1]->getType())
+			checked = false;
+		find_keys(ho, checked and ho->isNode(), keys, consts, wild);
+	}
+}
+
+static bool has_glob(const Handle& h)
+{
+	for (const Handle& ho : h->getOutgoingSet())
+		if (GLOB_NODE == ho->getType()) return true;
+	return false;
+}
+
+static void find_nodes(const Handle& h, UnorderedHandleSet& nodes)
+{
+	if (h->isNode())
+	{
+		nodes.insert(h);
+		return;
+	}
+	for (const Handle& ho : h->getOutgoingSet())
+		find_nodes(ho, nodes);
+}
+
+/* ======================================================== */
+
+RecognizerIndex::RecognizerIndex(AtomSpace* as) :
+	_as(as)
+{
+	// Connect before the scan, so that no atom is missed; an atom
+	// seen twice is indexed once.  The scan takes in the parent
+	// atomspaces, so their signals are needed as well.
+	for (AtomSpace* env = as; env; env = env->get_environ())
+	{
+		_connections.push_back(env->addAtomSignal(
+			boost::bind(&RecognizerIndex::atom_added, this, _1)));
+		_connections.push_back(env->removeAtomSignal(
+			boost::bind(&RecognizerIndex::atom_removed, this, _1)));
+	}
+
+	HandleSeq links;
+	as->get_handles_by_type(links, LINK, true);
+	for (const Handle& h : links)
+		insert(h);
+}
+
+RecognizerIndex::~RecognizerIndex()
+{
+	for (boost::signals2::connection& c : _connections)
+		c.disconnect();
+}
+
+void RecognizerIndex::insert(const Handle& h)
+{
+	UnorderedHandleSet keys, consts;
+	bool wild = false;
+	find_keys(h, true, keys, consts, wild);
+	if (not wild or consts.empty()) return;
+
+	std::lock_guard<std::mutex> lck(_mtx);
+	if (not _patterns.insert({h, {keys.size(), has_glob(h)}}).second)
+		return;
+
+	for (const Handle& key : keys)
+		_by_key[key].insert(h);
+	if (keys.empty())
+		for (const Handle& c : consts)
+			_unkeyed[c].insert(h);
+}
+
+void RecognizerIndex::atom_added(const Handle& h)
+{
+	if (h->isLink()) insert(h);
+}
+
+void RecognizerIndex::atom_removed(const AtomPtr& atom)
+{
+	if (not atom->isLink()) return;
+	Handle h(atom->getHandle());
+
+	std::lock_guard<std::mutex> lck(_mtx);
+	if (0 == _patterns.erase(h)) return;
+
+	UnorderedHandleSet keys, consts;
+	bool wild = false;
+	find_keys(h, true, keys, consts, wild);
+
+	auto drop = [&](std::unordered_map<Handle, UnorderedHandleSet>& idx,
+	                const Handle& key)
+	{
+		auto it = idx.find(key);
+		if (idx.end() == it) return;
+		it->second.erase(h);
+		if (it->second.empty()) idx.erase(it);
+	};
+	for (const Handle& key : keys)
+		drop(_by_key, key);
+	if (keys.empty())
+		for (const Handle& c : consts)
+			drop(_unkeyed, c);
+}
+
+HandleSeq RecognizerIndex::candidates(const Handle& term)
+{
+	HandleSeq cands;
+	if (not term->isLink()) return cands;
+
+	UnorderedHandleSet nodes;
+	find_nodes(term, nodes);
+
+	Type t = term->getType();
+	Arity ar = term->getArity();
+	auto fits = [&](const Handle& pat, const Entry& ent)
+	{
+		return pat->getType() == t and
+		       (ent.any_arity or pat->getArity() == ar);
+	};
+
+	std::lock_guard<std::mutex> lck(_mtx);
+
+	// Count, for each pattern, how many of its keys the term holds.
+	std::unordered_map<Handle, size_t> hits;
+	UnorderedHandleSet unkeyed;
+	for (const Handle& n : nodes)
+	{
+		auto it = _by_key.find(n);
+		if (_by_key.end() != it)
+			for (const Handle& pat : it->second)
+				hits[pat]++;
+
+		auto unk = _unkeyed.find(n);
+		if (_unkeyed.end() != unk)
+			unkeyed.insert(unk->second.begin(), unk->second.end());
+	}
+
+	for (const auto& hit : hits)
+	{
+		const Entry& ent = _patterns.at(hit.first);
+		if (hit.second == ent.nkeys and fits(hit.first, ent))
+			cands.push_back(hit.first);
+	}
+	for (const Handle& pat : unkeyed)
+		if (fits(pat, _patterns.at(pat)))
+			cands.push_back(pat);
+
+	return cands;
+}
+
+size_t RecognizerIndex::size(void)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	return _patterns.size();
+}
+
+/* ===================== END OF FILE ===================== */
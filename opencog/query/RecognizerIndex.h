@@ -0,0 +1,109 @@
+/*
+ * RecognizerIndex.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef _OPENCOG_RECOGNIZER_INDEX_H
+#define _OPENCOG_RECOGNIZER_INDEX_H
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/signals2.hpp>
+
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog {
+
+class AtomSpace;
+
+/**
+ * class RecognizerIndex -- an inverted index of the patterns stored
+ * in an atomspace, for recognize().
+ *
+ * The recognizer looks for the stored atoms holding variables or globs
+ * (the bodies of rules, typically) that a given ground term would be a
+ * grounding of. Without an index, it walks up from every node of the
+ * term through the incoming sets, and tries the matcher on every link
+ * it meets; with many stored rules that share common words, that is a
+ * lot of links.
+ *
+ * A stored pattern can only match terms that have the same root type,
+ * the same arity (unless globs in the root soak up the difference),
+ * and that contain every constant node the match checks. The index
+ * keys each pattern by those constant nodes. Candidates for a term are
+ * the patterns all of whose keys are among the nodes of the term; they
+ * are then verified by the pattern matcher, as before.
+ *
+ * Constant nodes that the recognizer does not check are not keys: the
+ * contents of links in a list with globs (only their types are
+ * compared), and the nodes after two globs in a row. A pattern without
+ * any key is a candidate for the terms of its type that share some
+ * constant node with it; that is how the search of the incoming sets
+ * finds it. As before, a pattern made only of variables and globs is
+ * never reported.
+ *
+ * The index is kept up to date through the atom-added and atom-removed
+ * signals of the atomspace, and of its parents, whose atoms the
+ * atomspace also holds.
+ */
+class RecognizerIndex
+{
+	public:
+		RecognizerIndex(AtomSpace*);
+		~RecognizerIndex();
+
+		/// Stored patterns that might have `term` as a grounding.
+		HandleSeq candidates(const Handle& term);
+
+		/// Number of patterns indexed.
+		size_t size(void);
+
+		AtomSpace* get_atomspace(void) const { return _as; }
+
+		/// False once the atomspace has been deleted; the signals
+		/// disconnect all of their slots when they go away.
+		bool alive(void) const { return _connections.front().connected(); }
+
+	private:
+		AtomSpace* _as;
+		std::vector<boost::signals2::connection> _connections;
+
+		struct Entry
+		{
+			size_t nkeys;
+			bool any_arity;
+		};
+
+		std::mutex _mtx;
+		std::unordered_map<Handle, Entry> _patterns;
+		std::unordered_map<Handle, UnorderedHandleSet> _by_key;
+		std::unordered_map<Handle, UnorderedHandleSet> _unkeyed;
+
+		void insert(const Handle&);
+		void atom_added(const Handle&);
+		void atom_removed(const AtomPtr&);
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_RECOGNIZER_INDEX_H
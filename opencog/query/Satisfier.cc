@@ -21,6 +21,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <typeinfo>
+
 #include <opencog/atomspace/AtomSpace.h>
 #include <opencog/atoms/pattern/PatternLink.h>
 
@@ -87,6 +89,23 @@ bool Satisfier::search_finished(bool done)
 	return rc;
 }
 
+/// A worker for a parallel search. Satisfaction is a yes/no question,
+/// so the worker just records its own answer, and the answers are
+/// combined after the worker has finished.
+PatternMatchCallback* Satisfier::clone_worker(void)
+{
+	if (typeid(*this) != typeid(Satisfier)) return nullptr;
+	return new Satisfier(InitiateSearchCB::_as);
+}
+
+void Satisfier::release_worker(PatternMatchCallback* pmc)
+{
+	Satisfier* worker = dynamic_cast<Satisfier*>(pmc);
+	if (worker and TruthValue::TRUE_TV() == worker->_result)
+		_result = TruthValue::TRUE_TV();
+	DefaultPatternMatchCB::release_worker(pmc);
+}
+
 // ===========================================================
 
 bool SatisfyingSet::grounding(const HandleMap &var_soln,
@@ -94,29 +113,46 @@ bool SatisfyingSet::grounding(const HandleMap &var_soln,
 {
 	// PatternMatchEngine::log_solution(var_soln, term_soln);
 
-	// Do not accept new solution if maximum number has been already reached
-	if (_satisfying_set.size() >= max_results)
-		return true;
+	// Worker threads report to the set that started the search.
+	SatisfyingSet* coll = _collector ? _collector : this;
 
+	Handle gnd;
 	if (1 == _varseq.size())
 	{
-		_satisfying_set.emplace(var_soln.at(_varseq[0]));
-
-		// If we found as many as we want, then stop looking for more.
-		return (_satisfying_set.size() >= max_results);
+		gnd = var_soln.at(_varseq[0]);
 	}
-
-	// If more than one variable, encapsulate in sequential order,
-	// in a ListLink.
-	HandleSeq vargnds;
-	for (const Handle& hv : _varseq)
+	else
 	{
-		vargnds.push_back(var_soln.at(hv));
+		// If more than one variable, encapsulate in sequential order,
+		// in a ListLink.
+		HandleSeq vargnds;
+		for (const Handle& hv : _varseq)
+		{
+			vargnds.push_back(var_soln.at(hv));
+		}
+		gnd = createLink(vargnds, LIST_LINK);
 	}
-	_satisfying_set.emplace(Handle(createLink(vargnds, LIST_LINK)));
+
+	std::lock_guard<std::mutex> lck(coll->_set_mutex);
+
+	// Do not accept new solution if maximum number has been already reached
+	if (coll->_satisfying_set.size() >= max_results)
+		return true;
+
+	coll->_satisfying_set.emplace(gnd);
 
 	// If we found as many as we want, then stop looking for more.
-	return (_satisfying_set.size() >= max_results);
+	return (coll->_satisfying_set.size() >= max_results);
+}
+
+PatternMatchCallback* SatisfyingSet::clone_worker(void)
+{
+	if (typeid(*this) != typeid(SatisfyingSet)) return nullptr;
+
+	SatisfyingSet* worker = new SatisfyingSet(InitiateSearchCB::_as);
+	worker->max_results = max_results;
+	worker->_collector = this;
+	return worker;
 }
 
 TruthValuePtr opencog::satisfaction_link(AtomSpace* as, const Handle& hlink)
@@ -24,6 +24,7 @@
 #ifndef _OPENCOG_SATISFIER_H
 #define _OPENCOG_SATISFIER_H
 
+#include <mutex>
 #include <vector>
 
 #include <opencog/truthvalue/TruthValue.h>
@@ -53,7 +54,8 @@ class Satisfier :
 		Satisfier(AtomSpace* as) :
 			InitiateSearchCB(as),
 			DefaultPatternMatchCB(as),
-			_result(TruthValue::FALSE_TV()) {}
+			_result(TruthValue::FALSE_TV())
+		{ use_position_index(); }
 		TruthValuePtr _result;
 
 		virtual void set_pattern(const Variables& vars,
@@ -73,6 +75,10 @@ class Satisfier :
 
 		// Final pass, if no grounding was found.
 		virtual bool search_finished(bool);
+
+		// Parallel search support.
+		virtual PatternMatchCallback* clone_worker(void);
+		virtual void release_worker(PatternMatchCallback*);
 };
 
 /**
@@ -93,7 +99,9 @@ class SatisfyingSet :
 {
 	public:
 		SatisfyingSet(AtomSpace* as) :
-			InitiateSearchCB(as), DefaultPatternMatchCB(as), max_results(SIZE_MAX) {}
+			InitiateSearchCB(as), DefaultPatternMatchCB(as),
+			max_results(SIZE_MAX), _collector(nullptr)
+		{ use_position_index(); }
 		HandleSeq _varseq;
 		HandleSet _satisfying_set;
 		size_t max_results;
@@ -113,6 +121,14 @@ class SatisfyingSet :
 		// groundings.
 		virtual bool grounding(const HandleMap &var_soln,
 		                       const HandleMap &term_soln);
+
+		// Parallel search support. The workers add their groundings
+		// to the satisfying set of the collector, under a lock.
+		virtual PatternMatchCallback* clone_worker(void);
+
+	protected:
+		SatisfyingSet* _collector;
+		std::mutex _set_mutex;
 };
 
 }; // namespace opencog
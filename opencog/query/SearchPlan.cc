@@ -0,0 +1,75 @@
+/*
+ * SearchPlan.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <sstream>
+
+#include <opencog/atoms/base/Atom.h>
+
+#include "SearchPlan.h"
+
+using namespace opencog;
+
+std::string SearchPlan::to_string(const std::string& indent) const
+{
+	std::stringstream ss;
+	ss << indent << "search method: " << search_method << std::endl;
+	if (root_clause)
+		ss << indent << "root clause:" << std::endl
+		   << root_clause->toShortString(indent + "   ");
+	if (start_term)
+		ss << indent << "start term:" << std::endl
+		   << start_term->toShortString(indent + "   ");
+	if (anchor)
+		ss << indent << "anchor:" << std::endl
+		   << anchor->toShortString(indent + "   ");
+	ss << indent << "estimated candidates: " << estimated_candidates
+	   << std::endl;
+
+	size_t n = 0;
+	for (const Step& st : steps)
+	{
+		ss << indent << "step " << n++ << ":";
+		if (st.optional) ss << " optional";
+		if (st.evaluatable) ss << " evaluatable";
+		if (st.black) ss << " black-box";
+		ss << " fanout=" << st.fanout
+		   << " unbound=" << st.unbound
+		   << " type-count=" << st.type_count << std::endl
+		   << st.clause->toShortString(indent + "   ");
+		if (st.joint)
+			ss << indent << " joined at:" << std::endl
+			   << st.joint->toShortString(indent + "   ");
+	}
+
+	n = 0;
+	for (const SearchPlan& comp : components)
+	{
+		ss << indent << "component " << n++ << ":" << std::endl;
+		ss << comp.to_string(indent + "   ");
+	}
+	for (const Handle& v : virtuals)
+		ss << indent << "virtual:" << std::endl
+		   << v->toShortString(indent + "   ");
+	return ss.str();
+}
+
+/* ===================== END OF FILE ===================== */
@@ -0,0 +1,100 @@
+/*
+ * SearchPlan.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_SEARCH_PLAN_H
+#define _OPENCOG_SEARCH_PLAN_H
+
+#include <string>
+#include <vector>
+
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog {
+
+/**
+ * How the pattern matcher would go about grounding a pattern: where
+ * the search would start, roughly how many candidates it would have
+ * to try, and the order in which the clauses would be joined. This is
+ * what PatternLink::explain() returns; working it out does not ground
+ * or evaluate anything.
+ *
+ * The clause order is an estimate. At run time, the engine orders
+ * the clauses by the number of links of the right type in the
+ * incoming set of the grounded joint (see
+ * PatternMatchEngine::get_next_thinnest_clause()), and that is not
+ * known until there is a grounding. The plan estimates it from the
+ * statistics of the atomspace (see TypeStats).
+ */
+struct SearchPlan
+{
+	struct Step
+	{
+		Handle clause;
+
+		// The variable or term that ties this clause to the ones
+		// before it; undefined for the root clause.
+		Handle joint;
+
+		// Estimated number of branches that joining this clause at
+		// the joint starts; zero for the root clause, or when there
+		// are no statistics to go by.
+		double fanout;
+
+		// Variables in the clause that none of the earlier clauses
+		// ground.
+		unsigned int unbound;
+
+		// Number of atoms in the atomspace of the same type as the
+		// clause; zero for evaluatable clauses.
+		size_t type_count;
+
+		bool optional;
+		bool evaluatable;
+		bool black;
+	};
+
+	SearchPlan(void) : estimated_candidates(0) {}
+
+	// One of the InitiateSearchCB methods ("range", "neighbor",
+	// "link-type", "variable", "no-search"), or "components" for a
+	// pattern with several components, which are then planned one
+	// by one.
+	std::string search_method;
+	Handle root_clause;
+	Handle start_term;
+
+	// For a neighbor search, the atom whose incoming set supplies the
+	// candidates.
+	Handle anchor;
+	size_t estimated_candidates;
+
+	std::vector<Step> steps;
+
+	std::vector<SearchPlan> components;
+	HandleSeq virtuals;
+
+	std::string to_string(const std::string& indent = "") const;
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_SEARCH_PLAN_H
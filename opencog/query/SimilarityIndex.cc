@@ -0,0 +1,243 @@
+/*
+ * SimilarityIndex.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+
+#include <opencog/util/exceptions.h>
+#include <opencog/atomspace/AtomSpace.h>
+#include <opencog/atomutils/FindUtils.h>
+
+#include "SimilarityIndex.h"
+
+using namespace opencog;
+
+/// The splitmix64 finalizer; a cheap, well-mixed 64-bit hash.
+static inline uint64_t mix(uint64_t x)
+{
+	x += 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+/// The features of a tree: each leaf, numbered by its occurrence, and
+/// each leaf at the end of its path of types.
+static void find_features(const Handle& h, uint64_t path,
+                          std::unordered_map<uint64_t, size_t>& seen,
+                          std::vector<uint64_t>& feats)
+{
+	path = mix(path ^ h->getType());
+
+	if (h->isNode())
+	{
+		uint64_t leaf = hash_value(h);
+		size_t nth = seen[leaf]++;
+		feats.push_back(mix(leaf + nth));
+		feats.push_back(mix(leaf ^ path));
+		return;
+	}
+
+	for (const Handle& ho : h->getOutgoingSet())
+		find_features(ho, path, seen, feats);
+}
+
+/* ======================================================== */
+
+SimilarityIndex::SimilarityIndex(AtomSpace* as, size_t bands, size_t rows) :
+	_as(as), _bands(bands), _rows(rows)
+{
+	if (0 == bands or 0 == rows)
+		throw InvalidParamException(TRACE_INFO,
+			"SimilarityIndex needs at least one band and one row");
+
+	// Connect before the scan, so that no atom is missed; an atom
+	// seen twice is indexed once. The scan takes in the parent
+	// atomspaces, so their signals are needed as well.
+	for (AtomSpace* env = as; env; env = env->get_environ())
+	{
+		_connections.push_back(env->addAtomSignal(
+			boost::bind(&SimilarityIndex::atom_added, this, _1)));
+		_connections.push_back(env->removeAtomSignal(
+			boost::bind(&SimilarityIndex::atom_removed, this, _1)));
+	}
+
+	HandleSeq links;
+	as->get_handles_by_type(links, LINK, true);
+	for (const Handle& h : links)
+		insert(h);
+}
+
+SimilarityIndex::~SimilarityIndex()
+{
+	for (boost::signals2::connection& c : _connections)
+		c.disconnect();
+}
+
+SimilarityIndex::Sketch SimilarityIndex::sketch(const Handle& h) const
+{
+	std::unordered_map<uint64_t, size_t> seen;
+	std::vector<uint64_t> feats;
+	find_features(h, 0, seen, feats);
+
+	Sketch sk(_bands * _rows, UINT64_MAX);
+	for (size_t i = 0; i < sk.size(); i++)
+	{
+		uint64_t seed = mix(i + 1);
+		for (uint64_t f : feats)
+			sk[i] = std::min(sk[i], mix(f ^ seed));
+	}
+	return sk;
+}
+
+uint64_t SimilarityIndex::bucket(const Sketch& sk, size_t band) const
+{
+	uint64_t key = mix(band);
+	for (size_t r = 0; r < _rows; r++)
+		key = mix(key ^ sk[band * _rows + r]);
+	return key;
+}
+
+static double agreement(const std::vector<uint64_t>& a,
+                        const std::vector<uint64_t>& b)
+{
+	size_t same = 0;
+	for (size_t i = 0; i < a.size(); i++)
+		if (a[i] == b[i]) same++;
+	return ((double) same) / a.size();
+}
+
+void SimilarityIndex::insert(const Handle& h)
+{
+	Sketch sk(sketch(h));
+
+	std::lock_guard<std::mutex> lck(_mtx);
+	if (not _sketches.insert({h, sk}).second) return;
+	for (size_t b = 0; b < _bands; b++)
+		_buckets[bucket(sk, b)].insert(h);
+}
+
+void SimilarityIndex::atom_added(const Handle& h)
+{
+	if (h->isLink()) insert(h);
+}
+
+void SimilarityIndex::atom_removed(const AtomPtr& atom)
+{
+	if (not atom->isLink()) return;
+	Handle h(atom->getHandle());
+
+	std::lock_guard<std::mutex> lck(_mtx);
+	auto it = _sketches.find(h);
+	if (_sketches.end() == it) return;
+
+	for (size_t b = 0; b < _bands; b++)
+	{
+		auto bk = _buckets.find(bucket(it->second, b));
+		if (_buckets.end() == bk) continue;
+		bk->second.erase(h);
+		if (bk->second.empty()) _buckets.erase(bk);
+	}
+	_sketches.erase(it);
+}
+
+/// The links that share some bucket with the sketch; the caller
+/// holds the lock.
+UnorderedHandleSet SimilarityIndex::find_candidates(const Sketch& sk)
+{
+	UnorderedHandleSet cands;
+	for (size_t b = 0; b < _bands; b++)
+	{
+		auto bk = _buckets.find(bucket(sk, b));
+		if (_buckets.end() != bk)
+			cands.insert(bk->second.begin(), bk->second.end());
+	}
+	return cands;
+}
+
+HandleSeq SimilarityIndex::similar(const Handle& target, size_t k)
+{
+	Sketch ts(sketch(target));
+
+	std::vector<std::pair<double, Handle>> ranked;
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		for (const Handle& h : find_candidates(ts))
+			ranked.push_back({agreement(ts, _sketches.at(h)), h});
+	}
+
+	// Most similar first; ties in a fixed order.
+	std::sort(ranked.begin(), ranked.end(),
+		[](const std::pair<double, Handle>& a,
+		   const std::pair<double, Handle>& b)
+		{
+			if (a.first != b.first) return a.first > b.first;
+			return a.second < b.second;
+		});
+
+	HandleSeq top;
+	for (const auto& r : ranked)
+	{
+		if (k <= top.size()) break;
+		if (is_atom_in_tree(target, r.second)) continue;
+		top.push_back(r.second);
+	}
+	return top;
+}
+
+size_t SimilarityIndex::candidates(const Handle& target)
+{
+	Sketch ts(sketch(target));
+
+	UnorderedHandleSet cands;
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		cands = find_candidates(ts);
+	}
+
+	size_t n = 0;
+	for (const Handle& h : cands)
+		if (not is_atom_in_tree(target, h)) n++;
+	return n;
+}
+
+double SimilarityIndex::estimate(const Handle& a, const Handle& b) const
+{
+	return agreement(sketch(a), sketch(b));
+}
+
+RankedHandleSeq SimilarityIndex::fuzzy_search(FuzzyMatch& fm,
+                                              const Handle& target,
+                                              size_t k)
+{
+	return fm.perform_search(target, similar(target, k));
+}
+
+size_t SimilarityIndex::size(void)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	return _sketches.size();
+}
+
+/* ===================== END OF FILE ===================== */
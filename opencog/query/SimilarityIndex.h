@@ -0,0 +1,125 @@
+/*
+ * SimilarityIndex.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef _OPENCOG_SIMILARITY_INDEX_H
+#define _OPENCOG_SIMILARITY_INDEX_H
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/signals2.hpp>
+
+#include <opencog/atoms/base/Handle.h>
+#include <opencog/atomutils/FuzzyMatch.h>
+
+namespace opencog {
+
+class AtomSpace;
+
+/**
+ * class SimilarityIndex -- an approximate index of the links of an
+ * atomspace, by similarity of their trees.
+ *
+ * Each link is described by a set of features: the nodes in its tree,
+ * counted with multiplicity (the second "Tom" is a different feature
+ * from the first), and each such node together with the path of link
+ * types leading down to it from the root. The similarity of two trees
+ * is the Jaccard index of their feature sets: the number of features
+ * in common, over the number in either.
+ *
+ * The index keeps a MinHash sketch of each link: the smallest hash of
+ * its features, under each of `bands * rows` hash functions. Two
+ * sketches agree on any one hash with a probability equal to the
+ * similarity of the trees. The sketches are cut into bands of `rows`
+ * hashes, and each band is hashed into a bucket (locality-sensitive
+ * hashing); trees that share a bucket are candidates. Trees with
+ * similarity s share some bucket with a probability of
+ * 1 - (1 - s^rows)^bands; more rows make for fewer, closer candidates,
+ * more bands for fewer misses. The default of 8 bands of 4 rows finds
+ * trees that are 80% alike 98% of the time, and those that are half
+ * alike 40% of the time, but trees that only share a node or two
+ * rarely; with single-row bands, those would all be candidates, which
+ * on a large atomspace is most of it.
+ *
+ * The candidates are ranked by their estimated similarity; the exact
+ * score, if any, is left to the caller, e.g. to a FuzzyMatch, with
+ * fuzzy_search(). Being approximate, the index may miss similar trees,
+ * particularly those that are only a little similar.
+ *
+ * The index holds the links of the atomspace and of its parents, and
+ * follows the atom-added and atom-removed signals of each of them. It
+ * costs `bands * rows` 64-bit words per link.
+ */
+class SimilarityIndex
+{
+	public:
+		SimilarityIndex(AtomSpace*, size_t bands = 8, size_t rows = 4);
+		~SimilarityIndex();
+
+		/// The (at most) k indexed links most similar to `target`, by
+		/// estimated similarity, most similar first. The target and
+		/// its subtrees are not included.
+		HandleSeq similar(const Handle& target, size_t k);
+
+		/// Number of indexed links that share a bucket with `target`,
+		/// not counting the target and its subtrees: the links that
+		/// similar() ranks.
+		size_t candidates(const Handle& target);
+
+		/// The estimated similarity of two trees, from their sketches.
+		double estimate(const Handle&, const Handle&) const;
+
+		/// Score the k most similar links with `fm`, and return the
+		/// ones it picks.
+		RankedHandleSeq fuzzy_search(FuzzyMatch& fm, const Handle& target,
+		                             size_t k);
+
+		/// Number of links indexed.
+		size_t size(void);
+
+	private:
+		typedef std::vector<uint64_t> Sketch;
+
+		AtomSpace* _as;
+		size_t _bands;
+		size_t _rows;
+		std::vector<boost::signals2::connection> _connections;
+
+		std::mutex _mtx;
+		std::unordered_map<Handle, Sketch> _sketches;
+		std::unordered_map<uint64_t, UnorderedHandleSet> _buckets;
+
+		Sketch sketch(const Handle&) const;
+		uint64_t bucket(const Sketch&, size_t band) const;
+		UnorderedHandleSet find_candidates(const Sketch&);
+
+		void insert(const Handle&);
+		void atom_added(const Handle&);
+		void atom_removed(const AtomPtr&);
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_SIMILARITY_INDEX_H
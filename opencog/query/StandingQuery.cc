@@ -0,0 +1,406 @@
+/*
+ * StandingQuery.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <set>
+
+#include <boost/bind.hpp>
+
+#include <opencog/atoms/base/ClassServer.h>
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "DefaultPatternMatchCB.h"
+#include "InitiateSearchCB.h"
+#include "StandingQuery.h"
+
+using namespace opencog;
+
+namespace opencog {
+
+/**
+ * Collects the groundings of a standing query, together with the
+ * clause groundings that support them. If an anchor is given, the
+ * search is started there, and only there: the anchor must ground
+ * the given clause.
+ */
+class StandingMatchCB :
+	public virtual InitiateSearchCB,
+	public virtual DefaultPatternMatchCB
+{
+	private:
+		StandingQuery* _sq;
+		Handle _clause;
+		Handle _anchor;
+
+	public:
+		std::vector<StandingQuery::Match> matches;
+
+		StandingMatchCB(StandingQuery* sq,
+		                const Handle& clause, const Handle& anchor) :
+			InitiateSearchCB(sq->_as), DefaultPatternMatchCB(sq->_as),
+			_sq(sq), _clause(clause), _anchor(anchor)
+		{ use_position_index(); }
+
+		virtual void set_pattern(const Variables& vars,
+		                         const Pattern& pat)
+		{
+			InitiateSearchCB::set_pattern(vars, pat);
+			DefaultPatternMatchCB::set_pattern(vars, pat);
+		}
+
+		virtual bool initiate_search(PatternMatchEngine* pme)
+		{
+			if (nullptr == _anchor)
+				return InitiateSearchCB::initiate_search(pme);
+			return pme->explore_neighborhood(_clause, _clause, _anchor);
+		}
+
+		virtual bool grounding(const HandleMap &var_soln,
+		                       const HandleMap &term_soln);
+};
+
+}
+
+bool StandingMatchCB::grounding(const HandleMap &var_soln,
+                                const HandleMap &term_soln)
+{
+	const HandleSeq& varseq = _sq->_varseq;
+
+	Handle gnd;
+	if (1 == varseq.size())
+	{
+		gnd = var_soln.at(varseq[0]);
+	}
+	else
+	{
+		HandleSeq vargnds;
+		for (const Handle& hv : varseq)
+			vargnds.push_back(var_soln.at(hv));
+		gnd = createLink(vargnds, LIST_LINK);
+	}
+
+	HandleSeq roots;
+	if (_sq->_incremental)
+	{
+		for (const Handle& cl : _pattern->mandatory)
+		{
+			auto it = term_soln.find(cl);
+			if (term_soln.end() != it) roots.push_back(it->second);
+		}
+	}
+
+	matches.emplace_back(gnd, roots);
+	return false;
+}
+
+// ===========================================================
+
+StandingQuery::StandingQuery(AtomSpace* as, const Handle& query) :
+	_as(as), _query(query), _stale(true)
+{
+	if (nullptr == query or
+	    not classserver().isA(query->getType(), PATTERN_LINK))
+		throw InvalidParamException(TRACE_INFO,
+			"StandingQuery: expecting a PatternLink");
+
+	_pattern = PatternLinkCast(query);
+	if (nullptr == _pattern)
+		_pattern = createPatternLink(*LinkCast(query));
+	_varseq = _pattern->get_variables().varseq;
+
+	const Pattern& pat = _pattern->get_pattern();
+	_incremental = _pattern->get_num_comps() <= 1
+		and pat.optionals.empty()
+		and pat.evaluatable_holders.empty()
+		and pat.executable_holders.empty()
+		and pat.defined_terms.empty()
+		and not pat.mandatory.empty();
+
+	for (const Handle& cl : pat.mandatory)
+	{
+		Type ct = cl->getType();
+		if (not cl->isLink() or QUOTE_LINK == ct or CHOICE_LINK == ct)
+			_incremental = false;
+	}
+}
+
+/// Run the pattern matcher, either over the whole atomspace, or
+/// starting at the anchor only.
+std::vector<StandingQuery::Match>
+StandingQuery::search(const Handle& clause, const Handle& anchor)
+{
+	StandingMatchCB cb(this, clause, anchor);
+	_pattern->satisfy(cb);
+	return cb.matches;
+}
+
+/// Call with the lock held. The change is recorded for take_delta(),
+/// and, if there is a listener, queued for notify().
+void StandingQuery::report(const Handle& gnd, bool added, Notices& notices)
+{
+	UnorderedHandleSet& same = added ? _added : _retracted;
+	UnorderedHandleSet& other = added ? _retracted : _added;
+	if (0 == other.erase(gnd))
+		same.insert(gnd);
+
+	if (_listener) notices.emplace_back(gnd, added);
+}
+
+/// Call with no lock held.
+void StandingQuery::notify(const Listener& lsn, const Notices& notices)
+{
+	for (const auto& n : notices)
+		lsn(n.first, n.second);
+}
+
+void StandingQuery::insert(const std::vector<Match>& found)
+{
+	Notices notices;
+	Listener lsn;
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		for (const Match& m : found)
+		{
+			if (not _matches.insert(m.first).second) continue;
+
+			_support[m.first] = m.second;
+			for (const Handle& root : m.second)
+				_supported_by[root].insert(m.first);
+			report(m.first, true, notices);
+		}
+		lsn = _listener;
+	}
+	notify(lsn, notices);
+}
+
+/// An atom grounding one of the clauses is going away; so is
+/// every grounding that used it.
+void StandingQuery::retract(const Handle& root)
+{
+	Notices notices;
+	Listener lsn;
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		auto sup = _supported_by.find(root);
+		if (_supported_by.end() == sup) return;
+
+		UnorderedHandleSet gone;
+		gone.swap(sup->second);
+		_supported_by.erase(sup);
+
+		for (const Handle& gnd : gone)
+		{
+			for (const Handle& other : _support[gnd])
+			{
+				auto it = _supported_by.find(other);
+				if (_supported_by.end() == it) continue;
+				it->second.erase(gnd);
+				if (it->second.empty()) _supported_by.erase(it);
+			}
+			_support.erase(gnd);
+			_matches.erase(gnd);
+			report(gnd, false, notices);
+		}
+		lsn = _listener;
+	}
+	notify(lsn, notices);
+}
+
+/// Re-run a stale query from scratch, and report the difference.
+void StandingQuery::refresh(void)
+{
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		if (not _stale) return;
+		_stale = false;
+	}
+
+	std::vector<Match> found(search(Handle::UNDEFINED, Handle::UNDEFINED));
+
+	if (_incremental)
+	{
+		insert(found);
+		return;
+	}
+
+	UnorderedHandleSet now;
+	for (const Match& m : found)
+		now.insert(m.first);
+
+	Notices notices;
+	Listener lsn;
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		for (const Handle& gnd : now)
+			if (_matches.end() == _matches.find(gnd))
+				report(gnd, true, notices);
+		for (const Handle& gnd : _matches)
+			if (now.end() == now.find(gnd))
+				report(gnd, false, notices);
+		_matches.swap(now);
+		lsn = _listener;
+	}
+	notify(lsn, notices);
+}
+
+HandleSeq StandingQuery::get_matches(void)
+{
+	refresh();
+	std::lock_guard<std::mutex> lck(_mtx);
+	return HandleSeq(_matches.begin(), _matches.end());
+}
+
+bool StandingQuery::take_delta(HandleSeq& added, HandleSeq& retracted)
+{
+	refresh();
+	std::lock_guard<std::mutex> lck(_mtx);
+	added.assign(_added.begin(), _added.end());
+	retracted.assign(_retracted.begin(), _retracted.end());
+	_added.clear();
+	_retracted.clear();
+	return not (added.empty() and retracted.empty());
+}
+
+void StandingQuery::set_listener(const Listener& lsn)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	_listener = lsn;
+}
+
+// ===========================================================
+
+QueryNetwork::QueryNetwork(AtomSpace* as) :
+	_as(as)
+{
+	_add_connection = as->addAtomSignal(
+		boost::bind(&QueryNetwork::atom_added, this, _1));
+	_remove_connection = as->removeAtomSignal(
+		boost::bind(&QueryNetwork::atom_removed, this, _1));
+}
+
+QueryNetwork::~QueryNetwork()
+{
+	_add_connection.disconnect();
+	_remove_connection.disconnect();
+}
+
+StandingQueryPtr QueryNetwork::add_query(const Handle& query)
+{
+	StandingQueryPtr sq(new StandingQuery(_as, query));
+
+	// Register before the initial search, so that atoms added while
+	// it runs are not missed; a grounding found twice is kept once.
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		_queries.push_back(sq);
+		if (sq->_incremental)
+		{
+			for (const Handle& cl : sq->_pattern->get_pattern().mandatory)
+				_by_type[cl->getType()].emplace_back(sq, cl);
+		}
+		else
+		{
+			_stale_on_change.push_back(sq);
+		}
+	}
+
+	sq->refresh();
+	return sq;
+}
+
+void QueryNetwork::remove_query(const StandingQueryPtr& sq)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	auto is_sq = [&](const StandingQueryPtr& q) { return q == sq; };
+	_queries.erase(std::remove_if(_queries.begin(), _queries.end(), is_sq),
+	               _queries.end());
+	_stale_on_change.erase(std::remove_if(_stale_on_change.begin(),
+	                                      _stale_on_change.end(), is_sq),
+	                       _stale_on_change.end());
+
+	for (auto it = _by_type.begin(); it != _by_type.end(); )
+	{
+		std::vector<Target>& tgts = it->second;
+		tgts.erase(std::remove_if(tgts.begin(), tgts.end(),
+			[&](const Target& t) { return t.first == sq; }), tgts.end());
+		if (tgts.empty()) it = _by_type.erase(it);
+		else it++;
+	}
+}
+
+size_t QueryNetwork::size(void)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	return _queries.size();
+}
+
+void QueryNetwork::atom_added(const Handle& h)
+{
+	std::vector<Target> targets;
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		for (const StandingQueryPtr& sq : _stale_on_change)
+		{
+			std::lock_guard<std::mutex> qlck(sq->_mtx);
+			sq->_stale = true;
+		}
+
+		auto it = _by_type.find(h->getType());
+		if (_by_type.end() == it) return;
+		targets = it->second;
+	}
+
+	// The searches run unlocked; they may take a while. The listeners
+	// are called unlocked, too; they may add or remove atoms.
+	for (const Target& t : targets)
+		t.first->insert(t.first->search(t.second, h));
+}
+
+void QueryNetwork::atom_removed(const AtomPtr& atom)
+{
+	Handle h(atom->getHandle());
+
+	// A query may have several clauses of this type.
+	std::vector<StandingQueryPtr> targets;
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		for (const StandingQueryPtr& sq : _stale_on_change)
+		{
+			std::lock_guard<std::mutex> qlck(sq->_mtx);
+			sq->_stale = true;
+		}
+
+		auto it = _by_type.find(h->getType());
+		if (_by_type.end() == it) return;
+
+		std::set<StandingQuery*> done;
+		for (const Target& t : it->second)
+			if (done.insert(t.first.get()).second)
+				targets.push_back(t.first);
+	}
+
+	// Retract with the network unlocked, as the listeners run then.
+	for (const StandingQueryPtr& sq : targets)
+		sq->retract(h);
+}
+
+/* ===================== END OF FILE ===================== */
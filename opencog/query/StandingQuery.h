@@ -0,0 +1,176 @@
+/*
+ * StandingQuery.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_STANDING_QUERY_H
+#define _OPENCOG_STANDING_QUERY_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/signals2.hpp>
+
+#include <opencog/atoms/pattern/PatternLink.h>
+
+namespace opencog {
+
+class AtomSpace;
+class QueryNetwork;
+
+/**
+ * class StandingQuery -- a pattern whose groundings are kept up to
+ * date as the atomspace changes.
+ *
+ * Standing queries are created by a QueryNetwork (see below). The
+ * groundings are reported the same way as satisfying_set() reports
+ * them: the grounding of the variable, if there is only one, else a
+ * ListLink of the variable groundings, in variable order. These
+ * ListLinks are not placed in any atomspace. A BindLink may be
+ * registered, but only its pattern is used; the implicand is not
+ * instantiated.
+ *
+ * Most patterns are maintained incrementally. A grounding of a pattern
+ * is made new only by a new atom grounding one of the clauses (every
+ * other atom in the grounding is held by a clause grounding, and so
+ * must be older than it); so, when an atom is added, the pattern
+ * matcher is started at that atom, for each clause it might ground,
+ * and nowhere else. When a clause grounding is removed, every
+ * grounding that used it is retracted. Both are proportional to the
+ * change, not to the size of the atomspace.
+ *
+ * Patterns with optional (absent) clauses, evaluatable or executable
+ * terms, defined predicates, several components, or clauses consisting
+ * of a bare variable can gain or lose groundings in ways that cannot
+ * be traced back to a single atom. These are simply marked stale when
+ * the atomspace changes, and re-run (once) the next time they are
+ * looked at; see is_incremental().
+ */
+class StandingQuery
+{
+	friend class QueryNetwork;
+	friend class StandingMatchCB;
+
+	public:
+		/// Called with each new (true) or retracted (false) grounding.
+		/// For incremental queries, this is called synchronously, by
+		/// the thread that added or removed the atom; otherwise, by
+		/// the thread that caused the re-run. No locks are held while
+		/// the listener runs, so it may call back into the query, or
+		/// change the atomspace.
+		typedef std::function<void(const Handle&, bool)> Listener;
+
+		/// The current set of groundings.
+		HandleSeq get_matches(void);
+
+		/// Groundings that appeared, and that went away, since the
+		/// last call (or since the query was registered). A grounding
+		/// that came and went in between is not reported at all.
+		/// Returns false if nothing changed.
+		bool take_delta(HandleSeq& added, HandleSeq& retracted);
+
+		void set_listener(const Listener&);
+
+		const Handle& get_query(void) const { return _query; }
+		bool is_incremental(void) const { return _incremental; }
+
+	private:
+		StandingQuery(AtomSpace*, const Handle&);
+
+		AtomSpace* _as;
+		Handle _query;
+		PatternLinkPtr _pattern;
+		HandleSeq _varseq;
+		bool _incremental;
+
+		std::mutex _mtx;
+		bool _stale;
+		UnorderedHandleSet _matches;
+		UnorderedHandleSet _added;
+		UnorderedHandleSet _retracted;
+		Listener _listener;
+
+		// The clause groundings each grounding depends on, and the
+		// reverse; used to retract groundings when atoms go away.
+		std::unordered_map<Handle, HandleSeq> _support;
+		std::unordered_map<Handle, UnorderedHandleSet> _supported_by;
+
+		typedef std::pair<Handle, HandleSeq> Match;
+		std::vector<Match> search(const Handle& clause,
+		                          const Handle& anchor);
+
+		// Changes are collected under the lock, and passed on to the
+		// listener after it is released.
+		typedef std::vector<std::pair<Handle, bool>> Notices;
+
+		void insert(const std::vector<Match>&);
+		void retract(const Handle& root);
+		void refresh(void);
+		void report(const Handle&, bool, Notices&);
+		static void notify(const Listener&, const Notices&);
+};
+
+typedef std::shared_ptr<StandingQuery> StandingQueryPtr;
+
+/**
+ * class QueryNetwork -- the set of standing queries on an atomspace.
+ *
+ * The network listens to the atom-added and atom-removed signals of
+ * the atomspace, and passes each atom only to those queries having a
+ * clause whose root is of the same type as the atom. Thus, adding
+ * atoms of a type that no query looks at costs a single hash lookup,
+ * however many queries are registered.
+ */
+class QueryNetwork
+{
+	public:
+		QueryNetwork(AtomSpace*);
+		~QueryNetwork();
+
+		/// Register a GetLink, SatisfactionLink or BindLink, and find
+		/// its current groundings. These are reported as the first
+		/// delta.
+		StandingQueryPtr add_query(const Handle&);
+		void remove_query(const StandingQueryPtr&);
+
+		size_t size(void);
+
+	private:
+		AtomSpace* _as;
+		boost::signals2::connection _add_connection;
+		boost::signals2::connection _remove_connection;
+
+		std::mutex _mtx;
+		std::vector<StandingQueryPtr> _queries;
+		std::vector<StandingQueryPtr> _stale_on_change;
+
+		typedef std::pair<StandingQueryPtr, Handle> Target;
+		std::unordered_map<Type, std::vector<Target>> _by_type;
+
+		void atom_added(const Handle&);
+		void atom_removed(const AtomPtr&);
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_STANDING_QUERY_H
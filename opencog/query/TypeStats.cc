@@ -0,0 +1,206 @@
+/*
+ * TypeStats.cc
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <map>
+
+#include <boost/bind.hpp>
+
+#include <opencog/atoms/base/Link.h>
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "AttachedRegistry.h"
+#include "TypeStats.h"
+
+using namespace opencog;
+
+TypeStats::Degrees::Degrees(void) :
+	links(0), atoms(0), degrees(0), squares(0.0)
+{
+}
+
+double TypeStats::Degrees::mean(void) const
+{
+	if (0 == atoms) return 0.0;
+	return ((double) degrees) / atoms;
+}
+
+double TypeStats::Degrees::expected_fanout(void) const
+{
+	if (0 == degrees) return 0.0;
+	return squares / degrees;
+}
+
+/// The histogram bucket of a degree: floor(log2(d)), for d > 0.
+static size_t bucket(size_t d)
+{
+	size_t b = 0;
+	while (d >>= 1) b++;
+	return b;
+}
+
+/* ======================================================== */
+
+TypeStats::TypeStats(AtomSpace* as) :
+	_as(as)
+{
+	// Scan first, and only then connect: unlike an index, the counts
+	// cannot tell an atom that was seen twice. The scan takes in the
+	// parent atomspaces, so their signals are needed as well.
+	HandleSeq atoms;
+	as->get_handles_by_type(atoms, ATOM, true);
+	for (const Handle& h : atoms)
+	{
+		if (h->isLink())
+			at(h->getType()).links++;
+
+		std::map<Type, size_t> degree;
+		for (const LinkPtr& lp : h->getIncomingSet())
+			degree[lp->getType()]++;
+		for (const auto& pr : degree)
+			moved(at(pr.first), 0, pr.second);
+	}
+
+	for (AtomSpace* env = as; env; env = env->get_environ())
+	{
+		_connections.push_back(env->addAtomSignal(
+			boost::bind(&TypeStats::atom_added, this, _1)));
+		_connections.push_back(env->removeAtomSignal(
+			boost::bind(&TypeStats::atom_removed, this, _1)));
+	}
+}
+
+TypeStats::~TypeStats()
+{
+	for (boost::signals2::connection& c : _connections)
+		c.disconnect();
+}
+
+/// The statistics of the type; the caller holds the lock, if needed.
+TypeStats::Degrees& TypeStats::at(Type t)
+{
+	if (_by_type.size() <= t) _by_type.resize(t + 1);
+	return _by_type[t];
+}
+
+/// Some atom went from degree `from` to degree `to`.
+void TypeStats::moved(Degrees& d, size_t from, size_t to)
+{
+	if (0 < from)
+	{
+		size_t b = bucket(from);
+		if (b < d.histogram.size() and 0 < d.histogram[b])
+			d.histogram[b]--;
+		d.squares -= ((double) from) * from;
+		d.degrees -= std::min(from, d.degrees);
+	}
+	else d.atoms++;
+
+	if (0 < to)
+	{
+		size_t b = bucket(to);
+		if (d.histogram.size() <= b) d.histogram.resize(b + 1);
+		d.histogram[b]++;
+		d.squares += ((double) to) * to;
+		d.degrees += to;
+	}
+	else if (0 < d.atoms) d.atoms--;
+
+	if (d.squares < 0.0) d.squares = 0.0;
+}
+
+/// The degrees, in the link type `t`, of the atoms of the link; zero
+/// for repeats, as an atom that appears twice holds the link once.
+static std::vector<size_t> degrees_held(const Handle& h, Type t)
+{
+	const HandleSeq& oset = h->getOutgoingSet();
+	std::vector<size_t> degree;
+	for (size_t i = 0; i < oset.size(); i++)
+	{
+		bool seen = false;
+		for (size_t j = 0; j < i; j++)
+			if (oset[j] == oset[i]) { seen = true; break; }
+		degree.push_back(seen ? 0 : oset[i]->getIncomingSetSizeByType(t));
+	}
+	return degree;
+}
+
+/// The new link is already in the incoming sets of its atoms.
+void TypeStats::atom_added(const Handle& h)
+{
+	if (not h->isLink()) return;
+	Type t = h->getType();
+
+	std::vector<size_t> degree(degrees_held(h, t));
+
+	std::lock_guard<std::mutex> lck(_mtx);
+	Degrees& d = at(t);
+	d.links++;
+	for (size_t deg : degree)
+		if (0 < deg) moved(d, deg - 1, deg);
+}
+
+/// The link is still in the incoming sets of its atoms.
+void TypeStats::atom_removed(const AtomPtr& atom)
+{
+	if (not atom->isLink()) return;
+	Handle h(atom->getHandle());
+	Type t = h->getType();
+
+	std::vector<size_t> degree(degrees_held(h, t));
+
+	std::lock_guard<std::mutex> lck(_mtx);
+	Degrees& d = at(t);
+	if (0 < d.links) d.links--;
+	for (size_t deg : degree)
+		if (0 < deg) moved(d, deg, deg - 1);
+}
+
+TypeStats::Degrees TypeStats::degrees(Type t)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	if (_by_type.size() <= t) return Degrees();
+	return _by_type[t];
+}
+
+double TypeStats::expected_fanout(Type t)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	if (_by_type.size() <= t) return 0.0;
+	return _by_type[t].expected_fanout();
+}
+
+/* ======================================================== */
+
+static AttachedRegistry<TypeStats> _attached;
+
+TypeStats* TypeStats::attach(AtomSpace* as)
+{
+	return _attached.attach(as);
+}
+
+TypeStats* TypeStats::attached(AtomSpace* as)
+{
+	return _attached.attached(as);
+}
+
+/* ===================== END OF FILE ===================== */
@@ -0,0 +1,131 @@
+/*
+ * TypeStats.h
+ *
+ * Copyright (C) 2016 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_TYPE_STATS_H
+#define _OPENCOG_TYPE_STATS_H
+
+#include <mutex>
+#include <vector>
+
+#include <boost/signals2.hpp>
+
+#include <opencog/atoms/base/Handle.h>
+#include <opencog/atoms/base/types.h>
+
+namespace opencog {
+
+class AtomSpace;
+
+/**
+ * class TypeStats -- how the links of each type are spread over the
+ * atoms that they hold; used to estimate the cost of joining clauses
+ * when a search is explained (see SearchPlan).
+ *
+ * The pattern matcher joins a clause to the ones before it by walking
+ * up the incoming set of the grounding of a shared variable. When the
+ * grounding is known, the engine counts the links of the right type
+ * exactly (see PatternMatchEngine::fanout()). When it is not, as when
+ * a search is planned ahead of time, an estimate is needed: how many
+ * links of a given type hold an atom that the search has reached. The
+ * search reaches atoms through links, and so it reaches the atoms of
+ * high degree more often; the estimate is thus the size-biased mean
+ * degree, the sum of the squared degrees over the sum of the degrees.
+ * Unlike the plain mean, it is not fooled by a skewed graph, where a
+ * few hubs hold most of the links.
+ *
+ * For each link type, this keeps the number of links, the number of
+ * distinct atoms that they hold, the sum of the degrees of those atoms
+ * (and of their squares), and a histogram of the degrees, in powers of
+ * two. The degree of an atom is the number of links of the type in its
+ * incoming set, as given by Atom::getIncomingSetSizeByType(); that set
+ * also holds the links of child atomspaces, so the numbers are only
+ * estimates, which is all that they are used for.
+ *
+ * The statistics are gathered by a scan of the atomspace and of its
+ * parents, and kept up to date through their atom-added and
+ * atom-removed signals. Atoms added during the scan may be missed.
+ *
+ * The search itself does not use them: by the time it picks the next
+ * clause, the joint is grounded, and its degree is counted exactly.
+ *
+ * As with the NumberIndex, the statistics attached to an atomspace
+ * with attach() are used by the explanations of the queries on that
+ * atomspace; they live until the atomspace is deleted.
+ */
+class TypeStats
+{
+	public:
+		struct Degrees
+		{
+			Degrees(void);
+			size_t links;
+			size_t atoms;
+			size_t degrees;
+			double squares;
+
+			/// Number of atoms with degree in [2^k, 2^(k+1)).
+			std::vector<size_t> histogram;
+
+			/// Mean degree of the atoms held by links of the type.
+			double mean(void) const;
+
+			/// Expected degree of an atom reached through a link.
+			double expected_fanout(void) const;
+		};
+
+		TypeStats(AtomSpace*);
+		~TypeStats();
+
+		/// The statistics of a link type.
+		Degrees degrees(Type);
+
+		/// Shorthand for degrees(t).expected_fanout().
+		double expected_fanout(Type);
+
+		AtomSpace* get_atomspace(void) const { return _as; }
+
+		/// False once the atomspace has been deleted.
+		bool alive(void) const { return _connections.front().connected(); }
+
+		/// Attach statistics to the atomspace, gathering them if it
+		/// has none yet, and return them.
+		static TypeStats* attach(AtomSpace*);
+
+		/// The statistics attached to the atomspace, or null if none.
+		static TypeStats* attached(AtomSpace*);
+
+	private:
+		AtomSpace* _as;
+		std::vector<boost::signals2::connection> _connections;
+
+		std::mutex _mtx;
+		std::vector<Degrees> _by_type;
+		Degrees& at(Type);
+
+		void moved(Degrees&, size_t from, size_t to);
+		void atom_added(const Handle&);
+		void atom_removed(const AtomPtr&);
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_TYPE_STATS_H
@@ -35,6 +35,10 @@ const std::string UREConfigReader::top_rbs_name = "URE";
 // Parameters
 const std::string UREConfigReader::attention_alloc_name = "URE:attention-allocation";
 const std::string UREConfigReader::max_iter_name = "URE:maximum-iterations";
+const std::string UREConfigReader::query_seconds_name = "URE:query-time-limit";
+const std::string UREConfigReader::query_compares_name = "URE:query-maximum-tree-compares";
+const std::string UREConfigReader::query_groundings_name = "URE:query-maximum-groundings";
+const std::string UREConfigReader::query_transients_name = "URE:query-maximum-transient-atoms";
 const std::string UREConfigReader::bc_complexity_penalty_name = "URE:BC:complexity-penalty";
 const std::string UREConfigReader::bc_max_bit_size_name = "URE:BC:maximum-bit-size";
 
@@ -58,6 +62,13 @@ UREConfigReader::UREConfigReader(AtomSpace& as, const Handle& rbs) : _as(as)
 	// Fetch attention allocation parameter
 	_common_params.attention_alloc = fetch_bool_param(attention_alloc_name, rbs);
 
+	// Fetch the limits on each query, if any
+	QueryBudget& qb = _common_params.query_budget;
+	qb.max_seconds = fetch_limit_param(query_seconds_name, rbs);
+	qb.max_tree_compares = fetch_limit_param(query_compares_name, rbs);
+	qb.max_groundings = fetch_limit_param(query_groundings_name, rbs);
+	qb.max_transient_atoms = fetch_limit_param(query_transients_name, rbs);
+
 	//////////////////////
 	// FC parameters    //
 	//////////////////////
@@ -93,6 +104,11 @@ int UREConfigReader::get_maximum_iterations() const
 	return _common_params.max_iter;
 }
 
+const QueryBudget& UREConfigReader::get_query_budget() const
+{
+	return _common_params.query_budget;
+}
+
 double UREConfigReader::get_complexity_penalty() const
 {
 	return _bc_params.complexity_penalty;
@@ -113,6 +129,11 @@ void UREConfigReader::set_maximum_iterations(int mi)
 	_common_params.max_iter = mi;
 }
 
+void UREConfigReader::set_query_budget(const QueryBudget& qb)
+{
+	_common_params.query_budget = qb;
+}
+
 void UREConfigReader::set_complexity_penalty(double cp)
 {
 	_bc_params.complexity_penalty = cp;
@@ -200,6 +221,28 @@ double UREConfigReader::fetch_num_param(const string& schema_name,
 	}
 }
 
+double UREConfigReader::fetch_limit_param(const string& schema_name,
+                                          const Handle& input)
+{
+	// Most rule-based systems set no limit; don't warn, and don't
+	// leave a SchemaNode behind, for those.
+	Handle param_schema = _as.get_node(SCHEMA_NODE, schema_name);
+	if (Handle::UNDEFINED == param_schema)
+		return 0.0;
+
+	HandleSeq outputs =
+		fetch_execution_outputs(param_schema, input, NUMBER_NODE);
+	if (outputs.empty())
+		return 0.0;
+
+	double limit = NumberNodeCast(outputs.front())->get_value();
+	if (limit < 0.0)
+		throw RuntimeException(TRACE_INFO,
+			"UREConfigReader - %s is %g, it can't be negative!",
+			schema_name.c_str(), limit);
+	return limit;
+}
+
 bool UREConfigReader::fetch_bool_param(const string& pred_name,
                                        const Handle& input)
 {
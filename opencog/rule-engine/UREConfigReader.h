@@ -27,6 +27,7 @@
 #include "Rule.h"
 
 #include <opencog/atomspace/AtomSpace.h>
+#include <opencog/query/QueryBudget.h>
 
 namespace opencog {
 
@@ -60,6 +61,7 @@ public:
 	RuleSet& get_rules();
 	bool get_attention_allocation() const;
 	int get_maximum_iterations() const;
+	const QueryBudget& get_query_budget() const;
 	// BC
 	double get_complexity_penalty() const;
 	double get_max_bit_size() const;
@@ -72,6 +74,7 @@ public:
 	// Common
 	void set_attention_allocation(bool);
 	void set_maximum_iterations(int);
+	void set_query_budget(const QueryBudget&);
 	// BC
 	void set_complexity_penalty(double);
 
@@ -92,6 +95,14 @@ public:
 	// parameter
 	static const std::string max_iter_name;
 
+	// Names of the SchemaNodes outputing the limits on each pattern
+	// matcher query run by the rule engine (see QueryBudget). Zero,
+	// the default, means no limit.
+	static const std::string query_seconds_name;
+	static const std::string query_compares_name;
+	static const std::string query_groundings_name;
+	static const std::string query_transients_name;
+
 	// Name of the complexity penalty parameter for the Backward
 	// Chainer
 	static const std::string bc_complexity_penalty_name;
@@ -115,6 +126,7 @@ private:
 		RuleSet rules;
 		bool attention_alloc;
 		int max_iter;
+		QueryBudget query_budget;
 	};
 	CommonParameters _common_params;
 
@@ -170,6 +182,12 @@ private:
 	                       const Handle& input,
 	                       double default_value = 0.0);
 
+	// Like fetch_num_param, for the optional query limits: return 0,
+	// meaning no limit, if the parameter isn't there, and throw if
+	// it is negative.
+	double fetch_limit_param(const std::string& schema_name,
+	                         const Handle& input);
+
 	// Given <pred_name> and <input> in
 	//
 	// EvaluationLink TV
@@ -224,7 +224,14 @@ void BackwardChainer::fulfill_fcs(const Handle& fcs)
 	// alternatively modify some HypotheticalLink wrapping the atoms
 	// of concerns instead of the atoms themselves, and only modify
 	// the atoms if there are existing results to copy back to _as.
-	Handle hresult = bindlink(&tmp_as, fcs);
+	//
+	// The query is cut short if it exceeds the configured budget;
+	// the results found until then are kept.
+	QueryBudget budget(_configReader.get_query_budget());
+	Handle hresult = budgeted_query(&tmp_as, fcs, budget);
+	if (budget.stopped())
+		LAZY_URE_LOG_DEBUG << "Query stopped early: "
+		                   << QueryBudget::status_name(budget.status);
 	HandleSeq results;
 	for (const Handle& result : hresult->getOutgoingSet())
 		results.push_back(_as.add_atom(result));
@@ -173,16 +173,40 @@ bool ForwardChainer::termination()
  */
 void ForwardChainer::apply_all_rules()
 {
-	for (const Rule& rule : _rules) {
-		ure_logger().debug("Apply rule %s", rule.get_name().c_str());
-		UnorderedHandleSet uhs = apply_rule(rule);
-
-		// Update
+	auto record = [&](const Rule& rule, const UnorderedHandleSet& uhs) {
 		_fcstat.add_inference_record(_iteration,
 		                             _as.add_node(CONCEPT_NODE, "dummy-source"),
 		                             rule, uhs);
 		update_potential_sources(uhs);
+	};
+
+	if (_search_focus_set) {
+		for (const Rule& rule : _rules) {
+			ure_logger().debug("Apply rule %s", rule.get_name().c_str());
+			record(rule, apply_rule(rule));
+		}
+		return;
+	}
+
+	// Over the whole atomspace, the rules are run as one batch, so
+	// that the premise clauses they have in common are grounded only
+	// once. The results of each rule are stored as soon as it is
+	// done, before the next rule runs, just as above.
+	AtomSpace derived_rule_as(&_as);
+	HandleSeq rhcpys;
+	std::vector<const Rule*> rules;
+	for (const Rule& rule : _rules) {
+		rhcpys.push_back(derived_rule_as.add_atom(rule.get_rule()));
+		rules.push_back(&rule);
 	}
+
+	const QueryBudget& limits = _configReader.get_query_budget();
+	batch_query(&derived_rule_as, rhcpys, SIZE_MAX, &limits,
+	            [&](size_t i, const Handle& set) {
+		ure_logger().debug("Applied rule %s", rules[i]->get_name().c_str());
+		HandleSeq results = set->getOutgoingSet();
+		record(*rules[i], store_results(results));
+	});
 }
 
 UnorderedHandleSet ForwardChainer::get_chaining_result()
@@ -319,6 +343,10 @@ UnorderedHandleSet ForwardChainer::apply_rule(const Rule& rule)
 {
 	HandleSeq results;
 
+	// Each application of the rule gets a fresh budget.
+	QueryBudget budget(_configReader.get_query_budget());
+	budget.reset();
+
 	if (_search_focus_set) {
 		// rule.get_rule() may introduce a new atom that satisfies
 		// condition for the output. In order to prevent this
@@ -331,6 +359,7 @@ UnorderedHandleSet ForwardChainer::apply_rule(const Rule& rule)
 		BindLinkPtr bl = BindLinkCast(rhcpy);
 		FocusSetPMCB fs_pmcb(&derived_rule_as, &_as);
 		fs_pmcb.implicand = bl->get_implicand();
+		fs_pmcb.budget = &budget;
 		bl->imply(fs_pmcb, false);
 		results = fs_pmcb.get_result_list();
 	}
@@ -338,10 +367,21 @@ UnorderedHandleSet ForwardChainer::apply_rule(const Rule& rule)
 	else {
 		AtomSpace derived_rule_as(&_as);
 		Handle rhcpy = derived_rule_as.add_atom(rule.get_rule());
-		Handle h = bindlink(&derived_rule_as, rhcpy);
+		Handle h = budgeted_query(&derived_rule_as, rhcpy, budget);
 		results = h->getOutgoingSet();
 	}
 
+	if (budget.stopped())
+		ure_logger().debug("Rule %s stopped early (%s), with %zu results",
+		                   rule.get_name().c_str(),
+		                   QueryBudget::status_name(budget.status),
+		                   results.size());
+
+	return store_results(results);
+}
+
+UnorderedHandleSet ForwardChainer::store_results(HandleSeq& results)
+{
 	// Take the results from applying the rule and add them in the
 	// given AtomSpace
 	auto add_results = [&](AtomSpace& as) {
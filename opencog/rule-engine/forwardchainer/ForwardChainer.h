@@ -124,6 +124,12 @@ protected:
 	 */
 	UnorderedHandleSet apply_rule(const Rule& rule);
 
+	/**
+	 * Add the results of applying a rule to the atomspace (or the
+	 * focus set), and return them.
+	 */
+	UnorderedHandleSet store_results(HandleSeq& results);
+
 public:
 	/**
 	 * Ctor. rbs is a Handle pointing to rule-based system.
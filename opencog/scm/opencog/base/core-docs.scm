@@ -354,6 +354,38 @@
        )
 ")
 
+(set-procedure-property! cog-incoming-by-position 'documentation
+"
+ cog-incoming-by-position ATOM TYPE POS
+    Return the links of type TYPE that hold ATOM at position POS of
+    their outgoing set, counting from zero. This is fast for atoms
+    with huge incoming sets if the position index was turned on with
+    cog-index-positions!
+
+    Example:
+       guile> (define x (ConceptNode \"abc\"))
+       guile> (define y (ConceptNode \"def\"))
+       guile> (ListLink x y)
+       guile> (ListLink y x)
+
+       guile> (cog-incoming-by-position x 'ListLink 1)
+       ((ListLink
+          (ConceptNode \"def\")
+          (ConceptNode \"abc\")
+       )
+       )
+")
+
+(set-procedure-property! cog-index-positions! 'documentation
+"
+ cog-index-positions! FLAG
+    Keep an index of the links of each type that hold a given atom at
+    a given position, in the current atomspace, if FLAG is true; drop
+    it if FLAG is #f. This speeds up cog-incoming-by-position, and the
+    pattern matcher, when it walks up from an atom with many incoming
+    links; it costs an index entry per outgoing atom of every link.
+")
+
 (set-procedure-property! cog-outgoing-atom 'documentation
 "
  cog-outgoing-atom ATOM INDEX
@@ -940,6 +972,50 @@
        guile> (cog-map-type prt-atom 'ConceptNode)
 ")
 
+(set-procedure-property! cog-nodes-by-prefix 'documentation
+"
+ cog-nodes-by-prefix TYPE PREFIX
+    Return a list of the nodes of type TYPE whose names start with the
+    string PREFIX, in name order. As with cog-map-type, sub-types are
+    not included. This uses an index, and does not look at the other
+    nodes.
+
+    Example:
+       guile> (cog-nodes-by-prefix 'WordNode \"pre\")
+")
+
+(set-procedure-property! cog-nodes-by-range 'documentation
+"
+ cog-nodes-by-range TYPE LO HI
+    Return a list of the nodes of type TYPE whose names are at least
+    LO, and less than HI, in name order. Names are compared bytewise.
+
+    Example:
+       guile> (cog-nodes-by-range 'ConceptNode \"a\" \"b\")
+")
+
+(set-procedure-property! cog-nodes-by-substring 'documentation
+"
+ cog-nodes-by-substring TYPE STR
+    Return a list of the nodes of type TYPE whose names contain the
+    string STR, in no particular order. This looks at the name of
+    every node of that type, unless the trigram index was turned on
+    with cog-index-name-substrings!; then, for strings of at least
+    three characters, only a few names need to be checked.
+
+    Example:
+       guile> (cog-nodes-by-substring 'WordNode \"ing\")
+")
+
+(set-procedure-property! cog-index-name-substrings! 'documentation
+"
+ cog-index-name-substrings! FLAG
+    Keep an index of the three-letter pieces of every node name in the
+    current atomspace if FLAG is true, or drop it if FLAG is #f. This
+    speeds up cog-nodes-by-substring, at the cost of a few index
+    entries per node.
+")
+
 (set-procedure-property! cog-atomspace 'documentation
 "
  cog-atomspace
@@ -25,6 +25,17 @@
 (define-public (cog-satisfying-element handle)
 	(cog-satisfying-set-first-n handle 1)
 )
+(define-public (cog-cursor handle)
+	(cog-cursor-open handle 0 -1 #f)
+)
+(define-public (cog-pattern-profile handle)
+	(cog-pattern-profile-first-n handle -1)
+)
+(define*-public (cog-query-budget handle #:key (seconds 0)
+		(tree-compares 0) (groundings 0) (transient-atoms 0))
+	(cog-query-budget-prim handle seconds tree-compares groundings
+		transient-atoms)
+)
 
 (set-procedure-property! cog-bind 'documentation
 "
@@ -61,3 +72,190 @@
     Run pattern matcher on handle.  handle must be a SatisfactionLink.
     Return a TV. Only satisfaction is performed, no implication.
 ")
+
+(set-procedure-property! cog-cursor-open 'documentation
+"
+ cog-cursor-open handle offset limit add-results
+    Start a search for the BindLink or GetLink handle, and return an
+    integer cursor id. The results are obtained with cog-cursor-next,
+    as the pattern matcher finds them; they are not collected into a
+    SetLink. The first offset results are skipped, and the search
+    stops after limit results (-1 means no limit). Nothing is added
+    to the atomspace unless add-results is #t.
+
+    Example:
+       (define c (cog-cursor-open (GetLink (Variable \"$x\")
+             (Inheritance (Variable \"$x\") (Concept \"animal\")))
+             10 5 #f))
+       (cog-cursor-next c 2)  ; the 11th and 12th results
+       (cog-cursor-close c)
+")
+
+(set-procedure-property! cog-cursor 'documentation
+"
+ cog-cursor handle
+    Same as (cog-cursor-open handle 0 -1 #f).
+")
+
+(set-procedure-property! cog-cursor-next 'documentation
+"
+ cog-cursor-next cursor n
+    Return a list of up to n further results from the cursor. An
+    empty list means that the search is finished.
+")
+
+(set-procedure-property! cog-cursor-close 'documentation
+"
+ cog-cursor-close cursor
+    Halt the search, and release the cursor.
+")
+
+(set-procedure-property! cog-pattern-profile-first-n 'documentation
+"
+ cog-pattern-profile-first-n handle n
+    Run the BindLink or GetLink handle, as cog-bind-first-n or
+    cog-satisfying-set-first-n would, and return an association list
+    describing how the search went:
+       result          -- the SetLink of results
+       search-method   -- how the search was started: \"neighbor\",
+                          \"no-search\", \"link-type\" or \"variable\"
+       root-clause     -- the clause the search started with
+       start-term      -- the term in that clause that was anchored
+       candidates      -- number of candidate atoms for the start term
+       explored        -- number of those that were actually tried
+       tree-compares   -- number of term comparisons
+       permutations    -- number of unordered-link permutations tried
+       backtracks      -- list of (clause . count) pairs: the number
+                          of times the search backed out of each clause
+       virtual-evals   -- number of evaluatable clauses evaluated
+       virtual-seconds -- time spent evaluating them
+       transient-spaces -- number of scratch atomspaces set aside for that
+       transient-allocs -- how many of those had to be allocated
+       transient-atoms -- atoms left behind in them by the evaluations
+       groundings      -- number of groundings found
+       component-groundings -- for patterns with several components,
+                          the groundings found for each one, summed
+       duplicate-groundings -- groundings that a BindLink did not
+                          instantiate, having seen the same values
+       total-seconds   -- time taken by the whole query
+
+    Example:
+       (assoc-ref (cog-pattern-profile-first-n query 10) 'tree-compares)
+")
+
+(set-procedure-property! cog-pattern-profile 'documentation
+"
+ cog-pattern-profile handle
+    Same as (cog-pattern-profile-first-n handle -1).
+")
+
+(set-procedure-property! cog-explain 'documentation
+"
+ cog-explain handle
+    Report how the BindLink or GetLink handle would be searched,
+    without running the search. Nothing is grounded, and evaluatable
+    clauses are not evaluated. Returns an association list:
+       search-method   -- as for cog-pattern-profile, or \"components\"
+                          for a pattern with several components
+       root-clause     -- the clause the search would start with
+       start-term      -- the term in that clause that is anchored
+       anchor          -- the atom whose incoming set supplies the
+                          candidates, for a \"neighbor\" search
+       estimated-candidates -- number of candidates for the start term
+       steps           -- the clauses, in the order in which they are
+                          expected to be grounded; each is a list of
+                          clause, joint, fanout (estimated number of
+                          branches the join starts), unbound (number
+                          of variables not grounded by earlier
+                          clauses), type-count (number of atoms of
+                          the clause type), optional, evaluatable
+                          and black-box
+       components      -- for several components, a plan for each
+       virtuals        -- the clauses that join the components
+
+    The order of the steps is only an estimate; the search picks
+    between clauses by the grounding of the joint, which is not known
+    until the search is run. The plan estimates the fanout of each
+    join from statistics of the degrees of the atoms, per link type;
+    these are gathered by the first cog-explain on an atomspace, and
+    then kept up to date.
+
+    Example:
+       (assoc-ref (cog-explain query) 'estimated-candidates)
+")
+
+(set-procedure-property! cog-query-budget 'documentation
+"
+ cog-query-budget handle #:seconds s #:tree-compares n
+                         #:groundings n #:transient-atoms n
+    Run the BindLink or GetLink handle, as cog-bind or
+    cog-satisfying-set would, but stop as soon as any one of the
+    given limits is used up. A limit of zero (the default) means no
+    limit. The limits are: wall-clock time, number of term
+    comparisons, number of groundings, and number of atoms created
+    in the scratch atomspace while evaluating virtual clauses.
+    Returns an association list:
+       result          -- the SetLink of the results found so far
+       status          -- 'complete, or the limit that stopped the
+                          search: 'deadline, 'tree-compares,
+                          'groundings or 'transient-atoms
+       tree-compares   -- the work done, as counted for the limits
+       groundings
+       transient-atoms
+
+    Example:
+       (cog-query-budget query #:seconds 2.5 #:groundings 100)
+")
+
+(set-procedure-property! cog-bind-batch 'documentation
+"
+ cog-bind-batch list-of-handles
+    Run each of the BindLinks or GetLinks in the list, as cog-bind or
+    cog-satisfying-set would, and return the list of results, one
+    SetLink per query, in the same order. Queries that have a clause
+    in common (up to the names of the variables) share the work:
+    the shared clause is grounded once, and each query then continues
+    from those groundings. The queries still run one at a time, in
+    order, and each sees what the earlier ones added; if an earlier
+    BindLink could have added atoms that ground the shared clause,
+    the clause is grounded again before it is used.
+
+    Example:
+       (cog-bind-batch (list rule-a rule-b rule-c))
+")
+
+(set-procedure-property! cog-recognize 'documentation
+"
+ cog-recognize handle
+    Find the stored patterns that the ground term `handle` (or the
+    body of the DualLink `handle`) would be a grounding of; that is,
+    run the pattern matcher in reverse. Returns a SetLink of the
+    matching patterns. This finds the same patterns as
+    (cog-execute! (DualLink ...)), but takes the candidates from an
+    index of the atomspace, which is built on first use and then kept
+    up to date.
+
+    Example:
+       (BindLink (List (Concept \"I\") (Glob \"$star\")) ...)
+       (cog-recognize (List (Concept \"I\") (Concept \"run\")))
+")
+
+(set-procedure-property! cog-number-range 'documentation
+"
+ cog-number-range lo hi
+    Return a list of the NumberNodes in the atomspace whose values lie
+    between `lo` and `hi`, both included, smallest first. The numbers
+    are found in an index of the atomspace, which is built on first
+    use and then kept up to date; so this does not look at every
+    NumberNode. Use -inf.0 or +inf.0 for an open-ended range.
+
+    Once built, the index is also used by cog-bind, cog-execute! and
+    the rule engine, for queries on this atomspace whose variables
+    are typed to NumberNode and bounded by GreaterThanLinks.
+
+    Example:
+       (NumberNode \"3\") (NumberNode \"7\") (NumberNode \"12\")
+       (cog-number-range 5 20)
+    returns
+       ((NumberNode \"7.000000\") (NumberNode \"12.000000\"))
+")
@@ -0,0 +1,137 @@
+/*
+ * opencog/truthvalue/CompactTruthValue.cc
+ *
+ * Copyright (C) 2017 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <typeinfo>
+
+#include <opencog/util/exceptions.h>
+
+#include <opencog/truthvalue/CompactTruthValue.h>
+
+using namespace opencog;
+
+CompactTruthValue::CompactTruthValue(strength_t m, confidence_t c)
+	: SimpleTruthValue(COMPACT_TRUTH_VALUE), _mean(m), _confidence(c)
+{
+}
+
+CompactTruthValue::CompactTruthValue(const TruthValue& source)
+	: SimpleTruthValue(COMPACT_TRUTH_VALUE),
+	  _mean(source.getMean()), _confidence(source.getConfidence())
+{
+}
+
+CompactTruthValue::CompactTruthValue(const CompactTruthValue& source)
+	: SimpleTruthValue(COMPACT_TRUTH_VALUE),
+	  _mean(source._mean), _confidence(source._confidence)
+{
+}
+
+CompactTruthValue::CompactTruthValue(const ProtoAtomPtr& source)
+	: SimpleTruthValue(COMPACT_TRUTH_VALUE)
+{
+	if (not source->isType(SIMPLE_TRUTH_VALUE, true))
+		throw RuntimeException(TRACE_INFO,
+			"Source must be a SimpleTruthValue");
+
+	const std::vector<double>& v(FloatValueCast(source)->value());
+	if (v.size() < 2)
+		throw RuntimeException(TRACE_INFO,
+			"Expecting a mean and a confidence");
+	_mean = v[0];
+	_confidence = v[1];
+}
+
+const std::vector<double>& CompactTruthValue::value() const
+{
+	// The inherited vector is left empty by the constructors, and is
+	// written exactly once, here; the floats never change after that.
+	std::call_once(_decoded, [this]() {
+		std::vector<double>& v = const_cast<std::vector<double>&>(_value);
+		v.resize(2);
+		v[MEAN] = _mean;
+		v[CONFIDENCE] = _confidence;
+	});
+	return _value;
+}
+
+count_t CompactTruthValue::getCount() const
+{
+	// Formula from PLN book; same as SimpleTruthValue.
+	confidence_t cf = std::min((confidence_t) _confidence, 0.9999998);
+	return static_cast<count_t>(DEFAULT_K * cf / (1.0 - cf));
+}
+
+TruthValuePtr CompactTruthValue::merge(const TruthValuePtr& other,
+                                       const MergeCtrl& mc) const
+{
+	switch (mc.tv_formula)
+	{
+		case MergeCtrl::TVFormula::HIGHER_CONFIDENCE:
+			return higher_confidence_merge(other);
+
+		case MergeCtrl::TVFormula::PLN_BOOK_REVISION:
+		{
+			if (not other->isType(SIMPLE_TRUTH_VALUE, true))
+				throw RuntimeException(TRACE_INFO,
+				                   "Don't know how to merge %s into a "
+				                   "CompactTruthValue using the default style",
+				                   typeid(*other).name());
+
+			count_t K = DEFAULT_K;
+			count_t count = getCount();
+			count_t count2 = other->getCount();
+#define CVAL  0.2f
+			count_t count_new = count + count2 - std::min(count, count2) * CVAL;
+			strength_t mean_new = (getMean() * count + other->getMean() * count2)
+				/ (count + count2);
+			confidence_t confidence_new = count_new / (count_new + K);
+			return createTV(mean_new, confidence_new);
+		}
+		default:
+			throw RuntimeException(TRACE_INFO,
+			                   "CompactTruthValue::merge: case not implemented");
+			return nullptr;
+	}
+}
+
+std::string CompactTruthValue::toString(const std::string& indent) const
+{
+	char buf[1024];
+	snprintf(buf, sizeof(buf), "(stv %f %f)", _mean, _confidence);
+	return buf;
+}
+
+/// Equal to any simple TV that has the same mean and confidence,
+/// after both have been rounded to single precision.
+bool CompactTruthValue::operator==(const ProtoAtom& rhs) const
+{
+	if (not rhs.isType(SIMPLE_TRUTH_VALUE, true)) return false;
+
+	const TruthValue* tv = dynamic_cast<const TruthValue*>(&rhs);
+	if (nullptr == tv) return false;
+
+	if ((float) tv->getMean() != _mean) return false;
+	if ((float) tv->getConfidence() != _confidence) return false;
+	return true;
+}
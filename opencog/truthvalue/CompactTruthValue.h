@@ -0,0 +1,110 @@
+/*
+ * opencog/truthvalue/CompactTruthValue.h
+ *
+ * Copyright (C) 2017 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_COMPACT_TRUTH_VALUE_H_
+#define _OPENCOG_COMPACT_TRUTH_VALUE_H_
+
+#include <mutex>
+
+#include <opencog/truthvalue/SimpleTruthValue.h>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+class CompactTruthValue;
+typedef std::shared_ptr<const CompactTruthValue> CompactTruthValuePtr;
+
+//! A single-precision SimpleTruthValue.
+//!
+//! The SimpleTruthValue keeps its mean and confidence in the
+//! heap-allocated vector inherited from FloatValue.  This one keeps
+//! them as two inline floats, and leaves the inherited vector empty,
+//! so that each TV costs one allocation instead of two.  The vector
+//! is only filled in if someone asks for value(), which is mostly
+//! done when serializing.  The precision loss (about 7 decimal
+//! digits) is far below anything that PLN or ECAN can make use of.
+//!
+//! As far as the rest of the system is concerned, this is a simple
+//! truth value: it is a SimpleTruthValue subclass, its type inherits
+//! from SIMPLE_TRUTH_VALUE, it prints as an stv, and it merges with
+//! other stv's.
+class CompactTruthValue : public SimpleTruthValue
+{
+protected:
+    float _mean;
+    float _confidence;
+    mutable std::once_flag _decoded;
+
+public:
+    CompactTruthValue(strength_t, confidence_t);
+    CompactTruthValue(const TruthValue&);
+    CompactTruthValue(const CompactTruthValue&);
+    CompactTruthValue(const ProtoAtomPtr&);
+
+    virtual bool operator==(const ProtoAtom& rhs) const;
+
+    std::string toString(const std::string&) const;
+
+    /// The floats, widened to doubles; used for serialization.  The
+    /// vector is decoded on the first call, and stays valid for the
+    /// lifetime of this TV.
+    const std::vector<double>& value() const;
+
+    strength_t getMean() const { return _mean; }
+    confidence_t getConfidence() const { return _confidence; }
+    count_t getCount() const;
+
+    /// Same PLN-book revision formula as the SimpleTruthValue.
+    TruthValuePtr merge(const TruthValuePtr&,
+                        const MergeCtrl& mc=MergeCtrl()) const;
+
+    static CompactTruthValuePtr createCTV(strength_t mean, confidence_t conf)
+    {
+        return std::make_shared<const CompactTruthValue>(mean, conf);
+    }
+    static TruthValuePtr createTV(strength_t mean, confidence_t conf)
+    {
+        return std::static_pointer_cast<const TruthValue>(createCTV(mean, conf));
+    }
+    static TruthValuePtr createTV(const ProtoAtomPtr& pap)
+    {
+        return std::static_pointer_cast<const TruthValue>(
+            std::make_shared<const CompactTruthValue>(pap));
+    }
+
+    TruthValuePtr clone() const
+    {
+        return std::make_shared<const CompactTruthValue>(*this);
+    }
+    TruthValue* rawclone() const
+    {
+        return new CompactTruthValue(*this);
+    }
+};
+
+/** @}*/
+} // namespace opencog
+
+#endif // _OPENCOG_COMPACT_TRUTH_VALUE_H_
@@ -92,7 +92,7 @@ confidence_t FuzzyTruthValue::getConfidence() const
 TruthValuePtr FuzzyTruthValue::merge(const TruthValuePtr& other,
                                      const MergeCtrl& mc) const
 {
-    if (other->getType() != SIMPLE_TRUTH_VALUE) {
+    if (not other->isType(SIMPLE_TRUTH_VALUE, true)) {
         throw RuntimeException(TRACE_INFO,
            "Don't know how to merge %s into a FuzzyTruthValue",
            typeid(*other).name());
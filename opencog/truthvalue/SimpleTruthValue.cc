@@ -30,6 +30,7 @@
 #include <opencog/util/platform.h>
 #include <opencog/util/exceptions.h>
 
+#include "CompactTruthValue.h"
 #include "SimpleTruthValue.h"
 
 //#define DPRINTF printf
@@ -38,6 +39,14 @@
 using namespace opencog;
 
 count_t SimpleTruthValue::DEFAULT_K = 800.0;
+bool SimpleTruthValue::USE_COMPACT = false;
+
+TruthValuePtr SimpleTruthValue::createTV(strength_t mean, confidence_t conf)
+{
+    if (USE_COMPACT)
+        return CompactTruthValue::createTV(mean, conf);
+    return std::static_pointer_cast<const TruthValue>(createSTV(mean, conf));
+}
 
 SimpleTruthValue::SimpleTruthValue(strength_t m, confidence_t c)
 	: TruthValue(SIMPLE_TRUTH_VALUE)
@@ -59,14 +68,14 @@ SimpleTruthValue::SimpleTruthValue(const SimpleTruthValue& source)
 	: TruthValue(SIMPLE_TRUTH_VALUE)
 {
     _value.resize(2);
-    _value[MEAN] = source._value[MEAN];
-    _value[CONFIDENCE] = source._value[CONFIDENCE];
+    _value[MEAN] = source.getMean();
+    _value[CONFIDENCE] = source.getConfidence();
 }
 
 SimpleTruthValue::SimpleTruthValue(const ProtoAtomPtr& source)
 	: TruthValue(SIMPLE_TRUTH_VALUE)
 {
-	if (source->getType() != SIMPLE_TRUTH_VALUE)
+	if (not source->isType(SIMPLE_TRUTH_VALUE, true))
 		throw RuntimeException(TRACE_INFO,
 			"Source must be a SimpleTruthValue");
 
@@ -106,7 +115,7 @@ TruthValuePtr SimpleTruthValue::merge(const TruthValuePtr& other,
         {
             // Based on Section 5.10.2(A heuristic revision rule for STV)
             // of the PLN book
-            if (other->getType() != SIMPLE_TRUTH_VALUE)
+            if (not other->isType(SIMPLE_TRUTH_VALUE, true))
                 throw RuntimeException(TRACE_INFO,
                                    "Don't know how to merge %s into a "
                                    "SimpleTruthValue using the default style",
@@ -140,6 +149,9 @@ std::string SimpleTruthValue::toString(const std::string& indent) const
 
 bool SimpleTruthValue::operator==(const ProtoAtom& rhs) const
 {
+    // Let the compact TV decide, so that equality is symmetric.
+    if (COMPACT_TRUTH_VALUE == rhs.getType()) return rhs == *this;
+
     const SimpleTruthValue *stv = dynamic_cast<const SimpleTruthValue *>(&rhs);
     if (NULL == stv) return false;
 
@@ -47,9 +47,20 @@ protected:
         CONFIDENCE /// Estimate of confidence of the observation.
     };
 
+    /// For subclasses that keep the mean and confidence elsewhere;
+    /// the inherited vector is left empty.
+    SimpleTruthValue(Type t) : TruthValue(t) {}
+
 public:
     static count_t DEFAULT_K;
 
+    /// When set, createTV() hands out single-precision
+    /// CompactTruthValues instead of SimpleTruthValues. This is the
+    /// global switch for making the compact form the default
+    /// representation of stv's created by the scheme and python
+    /// bindings, the rule engine, etc.
+    static bool USE_COMPACT;
+
     SimpleTruthValue(strength_t, confidence_t);
     SimpleTruthValue(const TruthValue&);
     SimpleTruthValue(const SimpleTruthValue&);
@@ -77,10 +88,7 @@ public:
     {
         return std::make_shared<const SimpleTruthValue>(mean, conf);
     }
-    static TruthValuePtr createTV(strength_t mean, confidence_t conf)
-    {
-        return std::static_pointer_cast<const TruthValue>(createSTV(mean, conf));
-    }
+    static TruthValuePtr createTV(strength_t mean, confidence_t conf);
     static TruthValuePtr createTV(const ProtoAtomPtr& pap)
     {
         return std::static_pointer_cast<const TruthValue>(
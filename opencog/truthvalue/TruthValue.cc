@@ -27,6 +27,7 @@
 #include <math.h>
 #include <stdio.h>
 
+#include <opencog/truthvalue/CompactTruthValue.h>
 #include <opencog/truthvalue/CountTruthValue.h>
 #include <opencog/truthvalue/FuzzyTruthValue.h>
 #include <opencog/truthvalue/GenericTruthValue.h>
@@ -169,6 +170,8 @@ TruthValuePtr TruthValue::factory(const ProtoAtomPtr& pap)
 	Type t = pap->getType();
 	if (SIMPLE_TRUTH_VALUE == t)
 		return SimpleTruthValue::createTV(pap);
+	if (COMPACT_TRUTH_VALUE == t)
+		return CompactTruthValue::createTV(pap);
 	if (COUNT_TRUTH_VALUE == t)
 		return CountTruthValue::createTV(pap);
 	if (FUZZY_TRUTH_VALUE == t)
@@ -6,7 +6,7 @@ from opencog.bindlink import stub_bindlink, bindlink, single_bindlink,\
                              first_n_bindlink, af_bindlink, \
                              satisfaction_link, satisfying_set, \
                              satisfying_element, first_n_satisfying_set, \
-                             execute_atom, evaluate_atom
+                             execute_atom, evaluate_atom, GroundingCursor
 
 from opencog.type_constructors import *
 from opencog.utilities import initialize_opencog, finalize_opencog
@@ -135,6 +135,19 @@ class BindlinkTest(TestCase):
         atom = first_n_satisfying_set(self.atomspace, self.getlink_atom, 5)
         self._check_result_setlink(atom, 3)
 
+    def test_grounding_cursor(self):
+        cursor = GroundingCursor(self.atomspace, self.getlink_atom)
+        results = list(cursor)
+        self.assertEquals(len(results), 3)
+        self.assertEquals(cursor.count, 3)
+
+        cursor = GroundingCursor(self.atomspace, self.bindlink_atom,
+                                 offset=1, limit=1)
+        self.assertEquals(len(list(cursor)), 1)
+
+        # Nothing is added to the atomspace.
+        self.assertEquals(self.atomspace.size(), self.starting_size)
+
     def test_satisfy(self):
         satisfaction_atom = SatisfactionLink(
             VariableList(),  # no variables
@@ -0,0 +1,85 @@
+;
+; unordered-wide.scm
+;
+; A wide unordered link. There are 8! ways of lining up the members
+; of the pattern with those of the data; almost all of them fail on
+; the very first mismatched member, and need not be explored.
+;
+
+; The raw data: a set of eight inheritance links.
+(SetLink
+	(InheritanceLink (ConceptNode "thing-0") (ConceptNode "class-0"))
+	(InheritanceLink (ConceptNode "thing-1") (ConceptNode "class-1"))
+	(InheritanceLink (ConceptNode "thing-2") (ConceptNode "class-2"))
+	(InheritanceLink (ConceptNode "thing-3") (ConceptNode "class-3"))
+	(InheritanceLink (ConceptNode "thing-4") (ConceptNode "class-4"))
+	(InheritanceLink (ConceptNode "thing-5") (ConceptNode "class-5"))
+	(InheritanceLink (ConceptNode "thing-6") (ConceptNode "class-6"))
+	(InheritanceLink (ConceptNode "thing-7") (ConceptNode "class-7"))
+)
+
+; This is almost the same, but has no class-7 at all, and so no
+; permutation can match.
+(SetLink
+	(InheritanceLink (ConceptNode "other-0") (ConceptNode "class-0"))
+	(InheritanceLink (ConceptNode "other-1") (ConceptNode "class-1"))
+	(InheritanceLink (ConceptNode "other-2") (ConceptNode "class-2"))
+	(InheritanceLink (ConceptNode "other-3") (ConceptNode "class-3"))
+	(InheritanceLink (ConceptNode "other-4") (ConceptNode "class-4"))
+	(InheritanceLink (ConceptNode "other-5") (ConceptNode "class-5"))
+	(InheritanceLink (ConceptNode "other-6") (ConceptNode "class-6"))
+	(InheritanceLink (ConceptNode "other-7") (ConceptNode "class-6"))
+)
+
+; Exactly one grounding.
+(define (wide)
+	(GetLink
+		(VariableList
+			(VariableNode "$x0")
+			(VariableNode "$x1")
+			(VariableNode "$x2")
+			(VariableNode "$x3")
+			(VariableNode "$x4")
+			(VariableNode "$x5")
+			(VariableNode "$x6")
+			(VariableNode "$x7")
+		)
+		(SetLink
+			(InheritanceLink (VariableNode "$x0") (ConceptNode "class-0"))
+			(InheritanceLink (VariableNode "$x1") (ConceptNode "class-1"))
+			(InheritanceLink (VariableNode "$x2") (ConceptNode "class-2"))
+			(InheritanceLink (VariableNode "$x3") (ConceptNode "class-3"))
+			(InheritanceLink (VariableNode "$x4") (ConceptNode "class-4"))
+			(InheritanceLink (VariableNode "$x5") (ConceptNode "class-5"))
+			(InheritanceLink (VariableNode "$x6") (ConceptNode "class-6"))
+			(InheritanceLink (VariableNode "$x7") (ConceptNode "class-7"))
+		)
+	)
+)
+
+; Some members are interchangeable; both groundings must be found.
+(SetLink
+	(MemberLink (ConceptNode "alpha") (ConceptNode "group"))
+	(MemberLink (ConceptNode "beta") (ConceptNode "group"))
+	(InheritanceLink (ConceptNode "gamma") (ConceptNode "kind"))
+	(InheritanceLink (ConceptNode "delta") (ConceptNode "kind"))
+	(EvaluationLink (PredicateNode "is") (ConceptNode "epsilon"))
+)
+
+(define (wide-swap)
+	(GetLink
+		(VariableList
+			(VariableNode "$a")
+			(VariableNode "$b")
+			(VariableNode "$c")
+			(VariableNode "$e")
+		)
+		(SetLink
+			(MemberLink (VariableNode "$a") (ConceptNode "group"))
+			(MemberLink (VariableNode "$b") (ConceptNode "group"))
+			(InheritanceLink (VariableNode "$c") (ConceptNode "kind"))
+			(InheritanceLink (ConceptNode "delta") (ConceptNode "kind"))
+			(EvaluationLink (PredicateNode "is") (VariableNode "$e"))
+		)
+	)
+)